@@ -0,0 +1,473 @@
+#include "conv_conversion.h"
+#include "conv_dense_matrix.h"
+#include "conv_formatting.h"
+#include "conv_mapped_file.h"
+#include "conv_parallel.h"
+#include "conv_parsing.h"
+#include "conv_perf_counters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using conv::HugePages;
+
+// The matrix takes 32 MB as doubles and about 30 MB as text.
+const std::size_t nRows = 4000;
+const std::size_t nCols = 1000;
+
+// A shape of about the same size whose dimensions are coprime. It is the
+// hardest case for the transposition in place.
+const std::size_t coprimeRows = 3989;
+const std::size_t coprimeCols = 1009;
+
+// Number of lines or rows which are processed by a task of the kernels.
+const std::size_t rowsPerTask = 64;
+
+// Each case is run this often and the fastest run is reported, which is
+// the one least disturbed by other processes.
+const int nRuns = 5;
+
+const char * const inputFileName = "benchmark_input.txt";
+const char * const outputFileName = "benchmark_output.txt";
+
+
+// Time and amount of data of a benchmark case.
+struct Measurement
+{
+    std::string name;
+    double seconds = 0;
+    std::size_t nValues = 0;
+    std::size_t nBytes = 0;
+    // hardware events of the fastest run, if they have been counted
+    bool hasCounts = false;
+    conv::PerfCounts counts;
+};
+
+
+// Counts hardware events during the measurements, if "--perf" is given.
+conv::PerfCounters * perfCounters = nullptr;
+
+
+// The data the kernels work on.
+struct Matrix
+{
+    std::string text;
+    // positions of the lines in the text, and the end of the text
+    std::vector<std::size_t> lineStarts;
+    std::vector<double> values;
+};
+
+
+// Stores the time and the hardware events of the fastest of several runs
+// of @c f in the result.
+void measure( Measurement & result, const std::function<void()> & f )
+{
+    for ( int run = 0; run < nRuns; ++run )
+    {
+        if ( perfCounters )
+            perfCounters->start();
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+        conv::PerfCounts counts;
+        if ( perfCounters )
+            counts = perfCounters->stop();
+        if ( run == 0 || elapsed.count() < result.seconds )
+        {
+            result.seconds = elapsed.count();
+            result.hasCounts = perfCounters != nullptr;
+            result.counts = counts;
+        }
+    }
+}
+
+
+// Generates numbers with two decimals like in typical measurement data
+// or, if @c hasDecimals is false, integers of the same digits.
+Matrix makeMatrix( bool hasDecimals )
+{
+    Matrix matrix;
+    std::mt19937 random( 42 );
+    std::uniform_int_distribution<int> value( -99999, 99999 );
+    for ( std::size_t i = 0; i < nRows; ++i )
+    {
+        matrix.lineStarts.push_back( matrix.text.size() );
+        for ( std::size_t j = 0; j < nCols; ++j )
+        {
+            char field[16];
+            const auto v = value( random );
+            if ( hasDecimals )
+                std::snprintf( field, sizeof(field), "%s%d.%02d ",
+                               v < 0 ? "-" : "", std::abs( v / 100 ),
+                               std::abs( v % 100 ) );
+            else
+                std::snprintf( field, sizeof(field), "%d ", v );
+            matrix.text += field;
+        }
+        matrix.text.back() = '\n';
+    }
+    matrix.lineStarts.push_back( matrix.text.size() );
+    matrix.values.resize( nRows * nCols );
+    return matrix;
+}
+
+
+const std::size_t nTasks = ( nRows + rowsPerTask - 1 ) / rowsPerTask;
+
+
+// The parse kernel: Splits the lines of a task into tokens and parses
+// them into the rows of @c values. @c text holds the text of the matrix.
+template <typename T>
+void parseTask( const char * text, const Matrix & matrix, T * values,
+                std::size_t task )
+{
+    const auto firstRow = task * rowsPerTask;
+    const auto lastRow = std::min( firstRow + rowsPerTask, nRows );
+    auto out = values + firstRow * nCols;
+    conv::forEachLine( text + matrix.lineStarts[firstRow],
+                       text + matrix.lineStarts[lastRow],
+                       [&]( const char * first, const char * last )
+    {
+        conv::forEachToken( first, last,
+                            [&]( const char * token, const char * tokenEnd )
+        {
+            if ( !conv::parseNumber( token, tokenEnd, *out++ ) )
+                std::abort();
+        } );
+    } );
+}
+
+
+// The format kernel: Formats the rows of a task as lines of text.
+template <typename T>
+void formatTask( const T * values, std::size_t task, std::string & text )
+{
+    text.clear();
+    const auto firstRow = task * rowsPerTask;
+    const auto lastRow = std::min( firstRow + rowsPerTask, nRows );
+    for ( auto i = firstRow; i != lastRow; ++i )
+    {
+        const auto row = values + i * nCols;
+        for ( std::size_t j = 0; j < nCols; ++j )
+        {
+            conv::appendNumber( text, row[j] );
+            text += ' ';
+        }
+        text += '\n';
+    }
+}
+
+
+// Splitting the lines into tokens and parsing them, in parallel like
+// in a conversion.
+Measurement benchmarkParse( Matrix & matrix )
+{
+    Measurement result;
+    result.name = "parse";
+    result.nValues = nRows * nCols;
+    result.nBytes = matrix.text.size();
+    measure( result, [&]()
+    {
+        conv::parallelFor( 0, nTasks, [&]( std::size_t task )
+        {
+            parseTask( matrix.text.data(), matrix, matrix.values.data(),
+                       task );
+        } );
+    } );
+    return result;
+}
+
+
+// Formatting the parsed values as lines of text.
+Measurement benchmarkFormat( const Matrix & matrix )
+{
+    std::vector<std::string> texts( nTasks );
+    Measurement result;
+    result.name = "format";
+    result.nValues = nRows * nCols;
+    measure( result, [&]()
+    {
+        conv::parallelFor( 0, nTasks, [&]( std::size_t task )
+        {
+            formatTask( matrix.values.data(), task, texts[task] );
+        } );
+    } );
+    for ( const auto & text : texts )
+        result.nBytes += text.size();
+    return result;
+}
+
+
+// Transposing a matrix in place in memory backed by the given kind of
+// pages. Returns false, if these pages are not available.
+bool benchmarkTranspose( std::size_t nRows, std::size_t nCols,
+                         HugePages hugePages, Measurement & result )
+{
+    conv::DenseMatrix<double> matrix( nRows, nCols, hugePages );
+    if ( matrix.hugePages() != hugePages )
+        return false;
+    // The pages are touched before the measurement, so page faults are
+    // not counted.
+    conv::parallelFor( 0, nRows, [&]( std::size_t i )
+    {
+        for ( std::size_t j = 0; j < nCols; ++j )
+            matrix.row( i )[j] = double( i*nCols + j );
+    } );
+    result.name = "transpose " + std::to_string( nRows ) + "x" +
+            std::to_string( nCols ) + ", " + describe( hugePages );
+    result.nValues = nRows * nCols;
+    result.nBytes = nRows * nCols * sizeof(double);
+    measure( result, [&]()
+    {
+        matrix.transpose();
+    } );
+    return true;
+}
+
+
+void writeInput( const Matrix & matrix )
+{
+    std::ofstream file( inputFileName, std::ios::binary );
+    file.write( matrix.text.data(), matrix.text.size() );
+}
+
+
+conv::ConversionOptions conversionOptions( bool shallTranspose,
+                                           conv::NumberType numberType )
+{
+    conv::ConversionOptions options;
+    options.inputFileName = inputFileName;
+    options.outputFileNames = outputFileName;
+    options.shallTranspose = shallTranspose;
+    options.numberType = numberType;
+    return options;
+}
+
+
+// A whole conversion from text to text. It parses and formats the same
+// values as the kernels above and in addition reads and writes the
+// files, stores the values and dispatches to the pipeline.
+Measurement benchmarkConvert( const Matrix & matrix, bool shallTranspose )
+{
+    writeInput( matrix );
+    const auto options =
+            conversionOptions( shallTranspose, conv::NumberType::Double );
+    Measurement result;
+    result.name = shallTranspose ? "convert transposed" : "convert";
+    result.nValues = nRows * nCols;
+    result.nBytes = matrix.text.size();
+    measure( result, [&]()
+    {
+        conv::convert( options );
+    } );
+    std::remove( inputFileName );
+    std::remove( outputFileName );
+    return result;
+}
+
+
+// Converts the input file like the pipeline does, but with nothing but
+// the kernels: The mapped text is parsed into a new matrix, whose rows
+// are formatted and written to the output file.
+template <typename T>
+void convertDirectly( const Matrix & matrix )
+{
+    const conv::MappedFile file( inputFileName );
+    std::vector<T> values( nRows * nCols );
+    conv::parallelFor( 0, nTasks, [&]( std::size_t task )
+    {
+        parseTask( file.begin(), matrix, values.data(), task );
+    } );
+    std::vector<std::string> texts( nTasks );
+    conv::parallelFor( 0, nTasks, [&]( std::size_t task )
+    {
+        formatTask( values.data(), task, texts[task] );
+    } );
+    std::ofstream output( outputFileName, std::ios::binary );
+    for ( const auto & text : texts )
+        output.write( text.data(), text.size() );
+}
+
+
+// The time a conversion spends beyond the kernels, i.e. in finding the
+// lines, planning, storing the values and the dispatch of the pipeline.
+// The same file is converted directly by the kernels and by the
+// pipeline, one right after the other, and the median of the
+// differences of these pairs is reported. So the noise of the runs does
+// not add up like for separately measured cases. The matrix should
+// consist of integers, since their kernels are several times faster
+// than those of doubles, whose noise would hide the overhead.
+Measurement benchmarkOverhead( const Matrix & integers )
+{
+    writeInput( integers );
+    const auto options =
+            conversionOptions( false, conv::NumberType::Int32 );
+    const auto seconds = []( const std::function<void()> & f )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+    std::vector<double> differences;
+    for ( int run = 0; run < nRuns; ++run )
+    {
+        const auto direct = seconds( [&]()
+        {
+            convertDirectly<std::int32_t>( integers );
+        } );
+        const auto pipeline =
+                seconds( [&]() { conv::convert( options ); } );
+        differences.push_back( pipeline - direct );
+    }
+    std::sort( begin(differences), end(differences) );
+    Measurement result;
+    result.name = "overhead";
+    result.seconds = differences[differences.size() / 2];
+    result.nValues = nRows * nCols;
+    std::remove( inputFileName );
+    std::remove( outputFileName );
+    return result;
+}
+
+
+// Prints the hardware events divided by @c n.
+void printCounts( const conv::PerfCounts & counts, std::size_t n,
+                  const char * unit )
+{
+    std::printf( "    per %-5s %9.2f cycles %9.2f instructions "
+                 "%8.4f cache %8.4f branch %8.4f dTLB misses\n", unit,
+                 double( counts.cycles ) / n,
+                 double( counts.instructions ) / n,
+                 double( counts.cacheMisses ) / n,
+                 double( counts.branchMisses ) / n,
+                 double( counts.dtlbMisses ) / n );
+}
+
+
+void print( const Measurement & m )
+{
+    std::printf( "%-44s %10.1f ms %10.2f ns/value", m.name.c_str(),
+                 m.seconds * 1e3, m.seconds * 1e9 / m.nValues );
+    if ( m.nBytes > 0 )
+        std::printf( " %8.3f ns/byte", m.seconds * 1e9 / m.nBytes );
+    std::printf( "\n" );
+    if ( !m.hasCounts )
+        return;
+    std::printf( "    IPC %.2f\n", m.counts.ipc() );
+    printCounts( m.counts, m.nValues, "value" );
+    if ( m.nBytes > 0 )
+        printCounts( m.counts, m.nBytes, "byte" );
+}
+
+
+bool isSelected( const std::vector<std::string> & cases,
+                 const char * name )
+{
+    return cases.empty() ||
+            std::find( begin(cases), end(cases), name ) != end(cases);
+}
+
+} // unnamed namespace
+
+
+/// Measures the kernels of the conversion and prints the time per value
+/// and per byte of text.
+///
+/// Run it as "benchmarks [case...]" with the cases "parse", "format",
+/// "transpose", "convert" and "overhead". Without arguments all cases are
+/// run. The transposition is measured for two shapes with each kind of
+/// memory pages which is available, the bytes being those of the values.
+/// The overhead is the time per value by which a conversion of integers
+/// is slower than the parse and format kernels applied directly to the
+/// same file, see benchmarkOverhead(). Hardware events are not counted
+/// for it.
+///
+/// With the option "--perf" the cycles, instructions, cache misses,
+/// branch misses and dTLB misses of each case are counted as well and
+/// printed per value and per byte. See conv::PerfCounters for the
+/// requirements.
+int main( int argc, char * argv[] )
+{
+    std::vector<std::string> cases( argv + 1, argv + argc );
+    const auto perfOption = std::find( begin(cases), end(cases), "--perf" );
+    const auto shallCount = perfOption != end(cases);
+    if ( shallCount )
+        cases.erase( perfOption );
+    try
+    {
+        auto matrix = makeMatrix( true );
+        std::printf( "%zu x %zu doubles, %zu bytes of text, %zu threads\n",
+                     nRows, nCols, matrix.text.size(),
+                     conv::ThreadPool::instance().nThreads() );
+        // The counters are opened after the workers of the thread pool
+        // have been started, so they count the workers as well.
+        std::unique_ptr<conv::PerfCounters> counters;
+        if ( shallCount )
+        {
+            counters.reset( new conv::PerfCounters );
+            if ( counters->isAvailable() )
+                perfCounters = counters.get();
+            else
+                std::printf( "hardware counters are not available\n" );
+        }
+        if ( isSelected( cases, "parse" ) )
+            print( benchmarkParse( matrix ) );
+        if ( isSelected( cases, "format" ) )
+        {
+            // The values are those of the parse kernel.
+            if ( !isSelected( cases, "parse" ) )
+                benchmarkParse( matrix );
+            print( benchmarkFormat( matrix ) );
+        }
+        if ( isSelected( cases, "transpose" ) )
+        {
+            for ( const auto hugePages : { HugePages::None,
+                                           HugePages::Transparent,
+                                           HugePages::Explicit2MB,
+                                           HugePages::Explicit1GB } )
+            {
+                Measurement transpose;
+                if ( !benchmarkTranspose( nRows, nCols, hugePages,
+                                          transpose ) )
+                {
+                    std::printf( "%s are not available\n",
+                                 describe( hugePages ) );
+                    continue;
+                }
+                print( transpose );
+                benchmarkTranspose( coprimeRows, coprimeCols, hugePages,
+                                    transpose );
+                print( transpose );
+            }
+        }
+        if ( isSelected( cases, "convert" ) )
+        {
+            print( benchmarkConvert( matrix, false ) );
+            print( benchmarkConvert( matrix, true ) );
+        }
+        if ( isSelected( cases, "overhead" ) )
+            print( benchmarkOverhead( makeMatrix( false ) ) );
+    }
+    catch ( std::exception & e )
+    {
+        std::fprintf( stderr, "%s\n", e.what() );
+        return 1;
+    }
+}
@@ -0,0 +1,189 @@
+#include "conv_arrow_writer.h"
+
+#include "conv_encoding.h"
+#include "conv_flat_buffer.h"
+
+#include "cpp_utils/exception.h"
+
+namespace conv
+{
+
+namespace detail
+{
+
+namespace
+{
+
+// Values of the enumerations in the Arrow format definition.
+const std::uint16_t metadataVersionV5 = 4;
+const std::uint8_t headerSchema = 1;
+const std::uint8_t headerRecordBatch = 3;
+const std::uint8_t typeInt = 2;
+const std::uint8_t typeFloatingPoint = 3;
+const std::uint16_t precisionDouble = 2;
+const std::uint16_t endiannessLittle = 0;
+const std::uint16_t endiannessBig = 1;
+
+const char magic[] = "ARROW1";
+
+using Builder = FlatBufferBuilder;
+
+
+// Adds a Schema table with a column of the type for each name.
+Builder::Table addSchema( Builder & builder, ArrowType type,
+                          const std::vector<std::string> & names )
+{
+    const auto nCols = names.size();
+    const auto schema = builder.addTable( {
+        Builder::scalar( 0, isLittleEndian() ? endiannessLittle
+                                             : endiannessBig, 2 ),
+        Builder::offset( 1 ) } );
+    const auto fields = builder.addOffsetVector( nCols );
+    builder.link( schema.fields[1], fields );
+    for ( std::size_t j = 0; j < nCols; ++j )
+    {
+        const auto isDouble = type == ArrowType::Double;
+        const auto field = builder.addTable( {
+            Builder::offset( 0 ),                 // name
+            Builder::scalar( 1, 0, 1 ),           // nullable
+            Builder::scalar( 2, isDouble ? typeFloatingPoint : typeInt, 1 ),
+            Builder::offset( 3 ),                 // type
+            Builder::offset( 5 ) } );             // children
+        builder.link( fields + 4 + 4*j, field.position );
+        builder.link( field.fields[0],
+                      builder.addString( names[j] ) );
+        const auto typeTable = isDouble
+                ? builder.addTable( {
+                      Builder::scalar( 0, precisionDouble, 2 ) } )
+                : builder.addTable( {
+                      Builder::scalar( 0, type == ArrowType::Int32 ? 32 : 64,
+                                       4 ),
+                      Builder::scalar( 1, 1, 1 ) } );     // is_signed
+        builder.link( field.fields[3], typeTable.position );
+        builder.link( field.fields[4], builder.addOffsetVector( 0 ) );
+    }
+    return schema;
+}
+
+
+// Returns a message with the flatbuffer of its header, which is added by
+// @c addHeader, preceded by the continuation marker and its size.
+template <typename F>
+std::string encapsulatedMessage( std::uint8_t headerType,
+                                 std::uint64_t bodyLength, F && addHeader )
+{
+    Builder builder;
+    const auto message = builder.addTable( {
+        Builder::scalar( 0, metadataVersionV5, 2 ),
+        Builder::scalar( 1, headerType, 1 ),
+        Builder::offset( 2 ),
+        Builder::scalar( 3, bodyLength, 8 ) } );
+    builder.setRoot( message );
+    builder.link( message.fields[2], addHeader( builder ) );
+    const auto flatBuffer = builder.finish();
+    std::string bytes;
+    appendLittleEndian( bytes, 0xFFFFFFFF, 4 );
+    appendLittleEndian( bytes, flatBuffer.size(), 4 );
+    return bytes + flatBuffer;
+}
+
+} // unnamed namespace
+
+
+std::string arrowFileStart()
+{
+    // The magic bytes are padded to eight bytes.
+    return std::string( magic, 6 ) + std::string( 2, '\0' );
+}
+
+
+std::string arrowSchemaMessage( ArrowType type,
+                                const std::vector<std::string> & names )
+{
+    return encapsulatedMessage( headerSchema, 0, [&]( Builder & builder )
+    {
+        return addSchema( builder, type, names ).position;
+    } );
+}
+
+
+std::string arrowRecordBatchMessage( std::size_t nRows, std::size_t nCols,
+                                     std::size_t valueSize )
+{
+    const auto columnBytes = nRows * valueSize;
+    const auto paddedBytes = ( columnBytes + 7 ) / 8 * 8;
+    return encapsulatedMessage( headerRecordBatch, nCols * paddedBytes,
+                                [&]( Builder & builder )
+    {
+        const auto batch = builder.addTable( {
+            Builder::scalar( 0, nRows, 8 ),      // length
+            Builder::offset( 1 ),                // nodes
+            Builder::offset( 2 ) } );            // buffers
+        // For each column a FieldNode with the length and the null count,
+        // and two Buffers with offset and length: the empty validity
+        // bitmap and the values.
+        std::string nodes;
+        std::string buffers;
+        for ( std::size_t j = 0; j < nCols; ++j )
+        {
+            appendLittleEndian( nodes, nRows, 8 );
+            appendLittleEndian( nodes, 0, 8 );
+            appendLittleEndian( buffers, j * paddedBytes, 8 );
+            appendLittleEndian( buffers, 0, 8 );
+            appendLittleEndian( buffers, j * paddedBytes, 8 );
+            appendLittleEndian( buffers, columnBytes, 8 );
+        }
+        builder.link( batch.fields[1],
+                      builder.addStructVector( nodes, nCols ) );
+        builder.link( batch.fields[2],
+                      builder.addStructVector( buffers, 2 * nCols ) );
+        return batch.position;
+    } );
+}
+
+
+std::string arrowFileEnd( ArrowType type,
+                          const std::vector<std::string> & names,
+                          const std::vector<ArrowBlock> & batches )
+{
+    Builder builder;
+    const auto footer = builder.addTable( {
+        Builder::scalar( 0, metadataVersionV5, 2 ),
+        Builder::offset( 1 ),                    // schema
+        Builder::offset( 2 ),                    // dictionaries
+        Builder::offset( 3 ) } );                // record batches
+    builder.setRoot( footer );
+    builder.link( footer.fields[1],
+                  addSchema( builder, type, names ).position );
+    builder.link( footer.fields[2], builder.addStructVector( "", 0 ) );
+    std::string blocks;
+    for ( const auto & batch : batches )
+    {
+        appendLittleEndian( blocks, batch.offset, 8 );
+        appendLittleEndian( blocks, batch.metaDataLength, 4 );
+        appendLittleEndian( blocks, 0, 4 );
+        appendLittleEndian( blocks, batch.bodyLength, 8 );
+    }
+    builder.link( footer.fields[3],
+                  builder.addStructVector( blocks, batches.size() ) );
+    const auto flatBuffer = builder.finish();
+
+    std::string bytes;
+    // end of stream marker
+    appendLittleEndian( bytes, 0xFFFFFFFF, 4 );
+    appendLittleEndian( bytes, 0, 4 );
+    bytes += flatBuffer;
+    appendLittleEndian( bytes, flatBuffer.size(), 4 );
+    bytes.append( magic, 6 );
+    return bytes;
+}
+
+
+void throwArrowWriteError( const std::string & fileName )
+{
+    CU_THROW( "Failed to write the Arrow file '" + fileName + "'." );
+}
+
+} // namespace detail
+
+} // namespace conv
@@ -0,0 +1,221 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_matrix_view.h"
+#include "conv_matrix_writer.h"
+#include "conv_parallel.h"
+#include "conv_trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+namespace detail
+{
+
+// Maximum number of values of a record batch.
+const std::size_t maxArrowBatchValues = 1 << 22;
+
+enum class ArrowType
+{
+    Double,
+    Int32,
+    Int64,
+};
+
+template <typename T> struct ArrowTypeOf;
+template <> struct ArrowTypeOf<double>
+{
+    static const ArrowType value = ArrowType::Double;
+};
+template <> struct ArrowTypeOf<std::int32_t>
+{
+    static const ArrowType value = ArrowType::Int32;
+};
+template <> struct ArrowTypeOf<std::int64_t>
+{
+    static const ArrowType value = ArrowType::Int64;
+};
+
+// Position and size of a record batch message in an Arrow file.
+struct ArrowBlock
+{
+    std::uint64_t offset = 0;
+    std::uint32_t metaDataLength = 0;
+    std::uint64_t bodyLength = 0;
+};
+
+// Returns the magic bytes at the beginning of an Arrow file.
+std::string arrowFileStart();
+
+// Returns the message which describes the columns with the given names.
+std::string arrowSchemaMessage( ArrowType type,
+                                const std::vector<std::string> & names );
+
+// Returns the metadata of a record batch in which each column has
+// @c nRows values of @c valueSize bytes. The body consists of the values
+// of the columns one after another, each padded to eight bytes.
+std::string arrowRecordBatchMessage( std::size_t nRows, std::size_t nCols,
+                                     std::size_t valueSize );
+
+// Returns the end of stream marker, the footer with the positions of the
+// record batches and the magic bytes at the end of an Arrow file.
+std::string arrowFileEnd( ArrowType type,
+                          const std::vector<std::string> & names,
+                          const std::vector<ArrowBlock> & batches );
+
+void throwArrowWriteError( const std::string & fileName );
+
+} // namespace detail
+
+
+/// Writes a matrix as an Arrow IPC file with one column of the matrix per
+/// Arrow column, which analytics tools can read without parsing.
+///
+/// Each block of rows is written as one or more record batches. The
+/// columns have no nulls, so there are no validity bitmaps and each
+/// column of a record batch is just the values in native byte order.
+/// The schema states the byte order. The columns are named after the
+/// given names or "c1", "c2" and so on, if there are none.
+///
+/// If the output is the transpose of a parsed matrix, then the columns
+/// of the output are the rows of the parsed matrix. They are contiguous
+/// in memory and are written as they are without copying. Otherwise the
+/// values of each column are gathered in parallel.
+template <typename T>
+class ArrowMatrixWriter : public MatrixWriter<T>
+{
+public:
+    explicit ArrowMatrixWriter(
+            const std::string & fileName,
+            const std::vector<std::string> & columnNames = {} )
+        : fileName( fileName )
+        , file( fileName, std::ios::binary )
+        , columnNames( columnNames )
+    {
+        write( detail::arrowFileStart() );
+    }
+
+    void append( const StridedView<T> & rows ) override
+    {
+        appendBatches( rows );
+    }
+
+    /// Appends the transposed view of a matrix without transposing it.
+    void append( const StridedView<T, true> & rows )
+    {
+        appendBatches( rows );
+    }
+
+    void finish() override
+    {
+        write( detail::arrowFileEnd( detail::ArrowTypeOf<T>::value,
+                                     columnNames, batches ) );
+        file.flush();
+        if ( !file.good() )
+            detail::throwArrowWriteError( fileName );
+    }
+
+private:
+    template <bool isTransposed>
+    void appendBatches( const StridedView<T, isTransposed> & rows )
+    {
+        if ( rows.nRows() == 0 )
+            return;
+        if ( !hasSchema )
+        {
+            nCols = rows.nCols();
+            if ( columnNames.empty() )
+                for ( std::size_t j = 0; j < nCols; ++j )
+                    columnNames.push_back( "c" + std::to_string( j+1 ) );
+            write( detail::arrowSchemaMessage( detail::ArrowTypeOf<T>::value,
+                                               columnNames ) );
+            hasSchema = true;
+        }
+        const auto rowsPerBatch = std::max<std::size_t>(
+                    detail::maxArrowBatchValues / std::max<std::size_t>(
+                        nCols, 1 ), 1 );
+        for ( std::size_t first = 0; first < rows.nRows();
+              first += rowsPerBatch )
+        {
+            const TraceScope trace( "write record batch",
+                                    first / rowsPerBatch );
+            writeBatch( rows, first,
+                        std::min( first + rowsPerBatch, rows.nRows() ) );
+        }
+    }
+
+    template <bool isTransposed>
+    void writeBatch( const StridedView<T, isTransposed> & rows,
+                     std::size_t first, std::size_t last )
+    {
+        const auto nRows = last - first;
+        const auto columnBytes = nRows * sizeof(T);
+        const auto padding = ( 8 - columnBytes % 8 ) % 8;
+        detail::ArrowBlock block;
+        block.offset = offset;
+        const auto metaData = detail::arrowRecordBatchMessage(
+                    nRows, nCols, sizeof(T) );
+        block.metaDataLength = static_cast<std::uint32_t>( metaData.size() );
+        block.bodyLength = nCols * ( columnBytes + padding );
+        write( metaData );
+        const char zeros[8] = {};
+        if ( StridedView<T, isTransposed>::hasContiguousRows )
+        {
+            // Gather the columns in parallel.
+            std::vector<T> columns( nRows * nCols );
+            parallelFor( 0, nCols, [&]( std::size_t j )
+            {
+                for ( auto i = first; i != last; ++i )
+                    columns[j*nRows + i - first] = rows(i,j);
+            } );
+            for ( std::size_t j = 0; j < nCols; ++j )
+            {
+                write( &columns[j*nRows], columnBytes );
+                write( zeros, padding );
+            }
+        }
+        else
+        {
+            for ( std::size_t j = 0; j < nCols; ++j )
+            {
+                write( &rows(first,j), columnBytes );
+                write( zeros, padding );
+            }
+        }
+        batches.push_back( block );
+    }
+
+    void write( const void * data, std::size_t size )
+    {
+        file.write( static_cast<const char *>( data ), size );
+        if ( !file.good() )
+            detail::throwArrowWriteError( fileName );
+        offset += size;
+    }
+
+    void write( const std::string & bytes )
+    {
+        write( bytes.data(), bytes.size() );
+    }
+
+    std::string fileName;
+    std::ofstream file;
+    std::vector<std::string> columnNames;
+    std::uint64_t offset = 0;
+    bool hasSchema = false;
+    std::size_t nCols = 0;
+    std::vector<detail::ArrowBlock> batches;
+};
+
+} // namespace conv
@@ -0,0 +1,167 @@
+#include "conv_buffer.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace conv
+{
+
+namespace
+{
+
+#ifdef __linux__
+const std::size_t mega = std::size_t(1) << 20;
+const std::size_t giga = std::size_t(1) << 30;
+
+std::size_t roundUp( std::size_t n, std::size_t multiple )
+{
+    return ( n + multiple - 1 ) / multiple * multiple;
+}
+
+// Maps explicit huge pages. Returns nullptr on failure.
+void * mapHugeTlbPages( std::size_t size, bool isGigabytePage )
+{
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    const int pageSizeFlag = ( isGigabytePage ? 30 : 21 ) << MAP_HUGE_SHIFT;
+    void * const p = mmap( nullptr, size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                           pageSizeFlag, -1, 0 );
+    return p == MAP_FAILED ? nullptr : p;
+#else
+    (void)size;
+    (void)isGigabytePage;
+    return nullptr;
+#endif
+}
+
+// Maps ordinary pages aligned to 2 MB and asks the kernel to back them
+// with transparent huge pages. Returns nullptr on failure.
+void * mapTransparentHugePages( std::size_t size )
+{
+    // Over-allocate in order to align the start to a huge page boundary
+    // and unmap the excess.
+    const auto mappedSize = size + 2*mega;
+    void * const p = mmap( nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( p == MAP_FAILED )
+        return nullptr;
+    const auto address = reinterpret_cast<std::size_t>( p );
+    const auto alignedAddress = roundUp( address, 2*mega );
+    if ( alignedAddress != address )
+        munmap( p, alignedAddress - address );
+    const auto excess = mappedSize - size - ( alignedAddress - address );
+    if ( excess != 0 )
+        munmap( reinterpret_cast<char *>( alignedAddress + size ), excess );
+#ifdef MADV_HUGEPAGE
+    madvise( reinterpret_cast<void *>( alignedAddress ), size,
+             MADV_HUGEPAGE );
+#endif
+    return reinterpret_cast<void *>( alignedAddress );
+}
+#endif
+
+} // unnamed namespace
+
+
+const char * describe( HugePages hugePages )
+{
+    switch ( hugePages )
+    {
+    case HugePages::None:        return "ordinary pages";
+    case HugePages::Transparent: return "transparent huge pages";
+    case HugePages::Explicit2MB: return "2 MB huge pages";
+    case HugePages::Explicit1GB: return "1 GB huge pages";
+    }
+    return "";
+}
+
+
+namespace detail
+{
+
+PageAllocation::PageAllocation( std::size_t nBytes, HugePages hugePages )
+{
+    if ( nBytes == 0 )
+        return;
+#ifdef __linux__
+    if ( hugePages == HugePages::Explicit1GB )
+    {
+        mappedSize = roundUp( nBytes, giga );
+        p = mapHugeTlbPages( mappedSize, true );
+        if ( p )
+        {
+            kind = HugePages::Explicit1GB;
+            return;
+        }
+        hugePages = HugePages::Explicit2MB;
+    }
+    if ( hugePages == HugePages::Explicit2MB )
+    {
+        mappedSize = roundUp( nBytes, 2*mega );
+        p = mapHugeTlbPages( mappedSize, false );
+        if ( p )
+        {
+            kind = HugePages::Explicit2MB;
+            return;
+        }
+        hugePages = HugePages::Transparent;
+    }
+    if ( hugePages == HugePages::Transparent )
+    {
+        mappedSize = roundUp( nBytes, 2*mega );
+        p = mapTransparentHugePages( mappedSize );
+        if ( p )
+        {
+            kind = HugePages::Transparent;
+            return;
+        }
+    }
+#else
+    (void)hugePages;
+#endif
+    // Big blocks from malloc() are fresh pages which are not touched.
+    mappedSize = 0;
+    p = std::malloc( nBytes );
+    if ( !p )
+        throw std::bad_alloc();
+}
+
+
+PageAllocation::~PageAllocation()
+{
+#ifdef __linux__
+    if ( mappedSize != 0 )
+    {
+        munmap( p, mappedSize );
+        return;
+    }
+#endif
+    std::free( p );
+}
+
+
+PageAllocation::PageAllocation( PageAllocation && other )
+    : p( other.p )
+    , mappedSize( other.mappedSize )
+    , kind( other.kind )
+{
+    other.p = nullptr;
+    other.mappedSize = 0;
+}
+
+
+PageAllocation & PageAllocation::operator=( PageAllocation && other )
+{
+    std::swap( p, other.p );
+    std::swap( mappedSize, other.mappedSize );
+    std::swap( kind, other.kind );
+    return *this;
+}
+
+} // namespace detail
+
+} // namespace conv
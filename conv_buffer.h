@@ -0,0 +1,103 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace conv
+{
+
+/// Kinds of memory pages big buffers can be backed with.
+///
+/// Huge pages reduce the number of TLB misses when a buffer is accessed
+/// with big strides, e.g. during a transposition.
+enum class HugePages
+{
+    /// ordinary pages
+    None,
+    /// transparent huge pages requested with @c madvise()
+    Transparent,
+    /// explicit 2 MB pages from the hugetlbfs pool
+    Explicit2MB,
+    /// explicit 1 GB pages from the hugetlbfs pool
+    Explicit1GB,
+};
+
+/// Returns a text like "2 MB huge pages" for messages.
+const char * describe( HugePages hugePages );
+
+
+namespace detail
+{
+
+// Memory obtained from the operating system. The pages are not touched.
+class PageAllocation
+{
+public:
+    PageAllocation() = default;
+    /// Falls back to less demanding kinds of pages, if the requested kind
+    /// is not available. Throws std::bad_alloc, if no memory is available.
+    PageAllocation( std::size_t nBytes, HugePages hugePages );
+    ~PageAllocation();
+
+    PageAllocation( PageAllocation && other );
+    PageAllocation & operator=( PageAllocation && other );
+
+    void * data() const { return p; }
+    /// The kind of pages which has actually been used.
+    HugePages hugePages() const { return kind; }
+
+private:
+    void * p = nullptr;
+    std::size_t mappedSize = 0;
+    HugePages kind = HugePages::None;
+};
+
+} // namespace detail
+
+
+/// Uninitialized storage for a fixed number of elements.
+///
+/// Unlike @c std::vector the elements are not initialized on allocation.
+/// Hence the memory pages of a big buffer are not touched by the
+/// allocating thread, and the operating system places each page on the
+/// NUMA node of the thread which writes to it first. Optionally the
+/// buffer is backed by huge pages.
+template <typename T>
+class Buffer
+{
+    static_assert( std::is_trivial<T>::value,
+                   "Buffer elements must not need initialization." );
+
+public:
+    Buffer() = default;
+
+    explicit Buffer( std::size_t size,
+                     HugePages hugePages = HugePages::None )
+        : allocation( size * sizeof(T), hugePages )
+        , n( size )
+    {
+    }
+
+    std::size_t size() const { return n; }
+    T * data() { return static_cast<T *>( allocation.data() ); }
+    const T * data() const { return static_cast<T *>( allocation.data() ); }
+    T * begin() { return data(); }
+    T * end() { return data() + n; }
+    const T * begin() const { return data(); }
+    const T * end() const { return data() + n; }
+
+    /// The kind of pages which backs the buffer.
+    HugePages hugePages() const { return allocation.hugePages(); }
+
+private:
+    detail::PageAllocation allocation;
+    std::size_t n = 0;
+};
+
+} // namespace conv
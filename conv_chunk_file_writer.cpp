@@ -0,0 +1,55 @@
+#include "conv_chunk_file_writer.h"
+
+#include "cpp_utils/exception.h"
+
+#include <ostream>
+
+namespace conv
+{
+
+namespace detail
+{
+
+void appendFooterStart( std::string & footer, std::uint32_t valueType,
+                        std::uint64_t nRows, std::uint64_t nCols )
+{
+    appendLittleEndian( footer, valueType, 4 );
+    appendLittleEndian( footer, 0, 4 );
+    appendLittleEndian( footer, nRows, 8 );
+    appendLittleEndian( footer, nCols, 8 );
+}
+
+
+void appendChunkEntry( std::string & footer, const ChunkEntry & chunk )
+{
+    appendLittleEndian( footer, chunk.offset, 8 );
+    appendLittleEndian( footer, chunk.size, 8 );
+    appendLittleEndian( footer,
+                        static_cast<std::uint32_t>( chunk.encoding ), 4 );
+}
+
+
+void writeFooter( std::ostream & file, std::string footer,
+                  const char * magic )
+{
+    appendLittleEndian( footer, footer.size(), 8 );
+    footer.append( magic, 8 );
+    file.write( footer.data(), footer.size() );
+}
+
+
+void writeMagic( std::ostream & file, const char * magic )
+{
+    file.write( magic, 8 );
+}
+
+
+void throwChunkFileWriteError( const std::string & kind,
+                               const std::string & fileName )
+{
+    CU_THROW( "Failed to write the " + kind + " file '" + fileName + "'." );
+}
+
+} // namespace detail
+
+} // namespace conv
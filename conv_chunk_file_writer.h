@@ -0,0 +1,207 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_encoding.h"
+#include "conv_matrix_view.h"
+#include "conv_matrix_writer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace conv
+{
+
+namespace detail
+{
+
+// Position of an encoded chunk in the file.
+struct ChunkEntry
+{
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+    ValueEncoding encoding = ValueEncoding::Plain;
+};
+
+// Appends the start of a footer: uint32 type of the values, uint32
+// padding, uint64 number of rows and uint64 number of columns.
+void appendFooterStart( std::string & footer, std::uint32_t valueType,
+                        std::uint64_t nRows, std::uint64_t nCols );
+
+// Appends uint64 offset, uint64 size and uint32 ValueEncoding of a chunk.
+void appendChunkEntry( std::string & footer, const ChunkEntry & chunk );
+
+// Appends the uint64 size of the footer and the magic bytes to the
+// footer and writes it.
+void writeFooter( std::ostream & file, std::string footer,
+                  const char * magic );
+
+// Writes the 8 magic bytes which begin and end a chunk file.
+void writeMagic( std::ostream & file, const char * magic );
+
+void throwChunkFileWriteError( const std::string & kind,
+                               const std::string & fileName );
+
+template <typename T> struct ChunkValueType;
+template <> struct ChunkValueType<double>       { enum { value = 1 }; };
+template <> struct ChunkValueType<std::int32_t> { enum { value = 2 }; };
+template <> struct ChunkValueType<std::int64_t> { enum { value = 3 }; };
+
+} // namespace detail
+
+
+/// Base class of the writers which encode blocks of rows into chunks
+/// and describe the chunks in a footer at the end of the file.
+///
+/// Appended rows are buffered until they fill a block of rowsPerBlock()
+/// rows. Whole blocks are passed to writeBlocks() without copying them.
+/// Rows without columns are only counted, so writeBlocks() is never
+/// called with zero columns.
+/// The file begins and ends with 8 magic bytes. The footer starts with
+/// the type of the values and the shape of the matrix, see
+/// detail::appendFooterStart(), and is followed by its size.
+template <typename T>
+class ChunkFileWriter : public MatrixWriter<T>
+{
+public:
+    void append( const StridedView<T> & rows ) override
+    {
+        if ( rows.nRows() == 0 )
+            return;
+        if ( blockRows == 0 )
+        {
+            nCols = rows.nCols();
+            blockRows = std::max<std::size_t>( rowsPerBlock(), 1 );
+        }
+        // Rows without values have nothing to encode, but are counted.
+        if ( nCols == 0 )
+        {
+            nRows += rows.nRows();
+            return;
+        }
+        std::size_t i = 0;
+        // Complete the pending block first.
+        if ( !pending.empty() )
+        {
+            i = std::min( blockRows - pending.size() / nCols, rows.nRows() );
+            keep( rows, 0, i );
+            if ( pending.size() == blockRows * nCols )
+                writePending();
+        }
+        // Whole blocks are encoded without copying them.
+        const auto nFull = ( rows.nRows() - i ) / blockRows * blockRows;
+        if ( nFull > 0 )
+            write( StridedView<T>( &rows(i,0), nFull, nCols,
+                                   rows.rowStride() ) );
+        keep( rows, i + nFull, rows.nRows() );
+    }
+
+    void finish() override
+    {
+        writePending();
+        std::string footer;
+        detail::appendFooterStart( footer, detail::ChunkValueType<T>::value,
+                                   nRows, nCols );
+        appendFooter( footer, chunks );
+        detail::writeFooter( file, std::move( footer ), magic );
+        file.flush();
+        checkFile();
+    }
+
+protected:
+    /// @param kind names the format in error messages.
+    ChunkFileWriter( const std::string & fileName, const char * magic,
+                     const char * kind )
+        : fileName( fileName )
+        , file( fileName, std::ios::binary )
+        , magic( magic )
+        , kind( kind )
+    {
+        detail::writeMagic( file, magic );
+        checkFile();
+        offset = 8;
+    }
+
+    /// Returns the number of rows which are encoded together. It is called
+    /// once, when nCols is known.
+    virtual std::size_t rowsPerBlock() const = 0;
+
+    /// Encodes and writes whole blocks of rows, except that the last
+    /// block may be shorter when the file is finished.
+    virtual void writeBlocks( const StridedView<T> & rows ) = 0;
+
+    /// Appends the rest of the footer with the entries of the chunks in
+    /// the order of the file, see detail::appendChunkEntry().
+    virtual void appendFooter(
+            std::string & footer,
+            const std::vector<detail::ChunkEntry> & chunks ) const = 0;
+
+    /// Writes an encoded chunk and records its entry for the footer.
+    void writeChunk( const EncodedValues & chunk )
+    {
+        detail::ChunkEntry entry;
+        entry.offset = offset;
+        entry.size = chunk.bytes.size();
+        entry.encoding = chunk.encoding;
+        chunks.push_back( entry );
+        file.write( chunk.bytes.data(), chunk.bytes.size() );
+        offset += chunk.bytes.size();
+    }
+
+    /// Throws, if the file could not be written.
+    void checkFile()
+    {
+        if ( !file.good() )
+            detail::throwChunkFileWriteError( kind, fileName );
+    }
+
+    std::size_t nCols = 0;
+    // rows per block, 0 before the first rows are appended
+    std::size_t blockRows = 0;
+
+private:
+    // Appends the rows from @c first to @c last to the pending rows.
+    void keep( const StridedView<T> & rows, std::size_t first,
+               std::size_t last )
+    {
+        for ( auto i = first; i < last; ++i )
+            pending.insert( end(pending), &rows(i,0), &rows(i,0) + nCols );
+    }
+
+    void writePending()
+    {
+        if ( pending.empty() )
+            return;
+        write( StridedView<T>( pending.data(), pending.size() / nCols,
+                               nCols, nCols ) );
+        pending.clear();
+    }
+
+    void write( const StridedView<T> & rows )
+    {
+        writeBlocks( rows );
+        nRows += rows.nRows();
+    }
+
+    std::string fileName;
+    std::ofstream file;
+    const char * magic;
+    const char * kind;
+    std::uint64_t offset = 0;
+    // number of rows which have been passed to writeBlocks()
+    std::uint64_t nRows = 0;
+    // rows which do not fill a block yet
+    std::vector<T> pending;
+    // the chunks in the order of the file
+    std::vector<detail::ChunkEntry> chunks;
+};
+
+} // namespace conv
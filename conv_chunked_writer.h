@@ -0,0 +1,126 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_chunk_file_writer.h"
+#include "conv_encoding.h"
+#include "conv_matrix_view.h"
+#include "conv_parallel.h"
+#include "conv_trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// Writes a matrix as a grid of rectangular chunks which are compressed
+/// separately, so that any part of the matrix can be read by decoding
+/// only the chunks which overlap it, like a chunked HDF5 dataset.
+///
+/// All chunks have the same shape, except for those at the right and
+/// bottom edges, which are cut off by the matrix. The values of a chunk
+/// are stored column by column, since neighbouring values in a column
+/// tend to be similar, and encoded by encodeSmallest(). Chunks are
+/// encoded in parallel as soon as enough rows for a row of chunks have
+/// been appended.
+///
+/// All numbers are stored in little endian byte order:
+/// - 8 bytes "CMCHUNK1"
+/// - the chunks
+/// - the footer:
+///   - uint32 type of the values (1 for double, 2 for int32, 3 for int64)
+///   - uint32 padding
+///   - uint64 number of rows and uint64 number of columns of the matrix
+///   - uint64 number of rows and uint64 number of columns of a chunk
+///   - for each chunk, row of chunks by row of chunks: uint64 offset of
+///     the chunk in the file, uint64 size in bytes and uint32
+///     ValueEncoding
+/// - uint64 size of the footer in bytes
+/// - 8 bytes "CMCHUNK1"
+template <typename T>
+class ChunkedMatrixWriter : public ChunkFileWriter<T>
+{
+public:
+    ChunkedMatrixWriter( const std::string & fileName,
+                         std::size_t chunkRows = 256,
+                         std::size_t chunkCols = 256 )
+        : ChunkFileWriter<T>( fileName, "CMCHUNK1", "chunked" )
+        , chunkRows( std::max<std::size_t>( chunkRows, 1 ) )
+        , chunkCols( std::max<std::size_t>( chunkCols, 1 ) )
+    {
+    }
+
+private:
+    std::size_t rowsPerBlock() const override
+    {
+        return chunkRows;
+    }
+
+    // Encodes and writes the rows as rows of chunks.
+    void writeBlocks( const StridedView<T> & rows ) override
+    {
+        const auto nCols = this->nCols;
+        const auto nBands = ( rows.nRows() + chunkRows - 1 ) / chunkRows;
+        const auto chunksPerBand = ( nCols + chunkCols - 1 ) / chunkCols;
+        // Several rows of chunks are encoded at once, if a row of chunks
+        // has not enough chunks for all threads.
+        const std::size_t valuesPerRound = 1 << 22;
+        const auto bandsPerRound = std::max<std::size_t>(
+                    valuesPerRound / ( chunkRows * nCols ), 1 );
+        std::vector<EncodedValues> encoded;
+        for ( std::size_t roundStart = 0; roundStart < nBands;
+              roundStart += bandsPerRound )
+        {
+            const auto roundEnd =
+                    std::min( roundStart + bandsPerRound, nBands );
+            encoded.assign( ( roundEnd - roundStart ) * chunksPerBand,
+                            EncodedValues() );
+            parallelFor( 0, encoded.size(), [&]( std::size_t k )
+            {
+                const auto band = roundStart + k / chunksPerBand;
+                const TraceScope trace( "encode chunk", band );
+                const auto firstRow = band * chunkRows;
+                const auto lastRow =
+                        std::min( firstRow + chunkRows, rows.nRows() );
+                const auto firstCol = k % chunksPerBand * chunkCols;
+                const auto lastCol = std::min( firstCol + chunkCols, nCols );
+                std::vector<T> chunk;
+                chunk.reserve( ( lastRow - firstRow ) *
+                               ( lastCol - firstCol ) );
+                for ( auto j = firstCol; j != lastCol; ++j )
+                    for ( auto i = firstRow; i != lastRow; ++i )
+                        chunk.push_back( rows(i,j) );
+                encoded[k] = encodeSmallest( chunk.data(), chunk.size() );
+            } );
+            const TraceScope trace( "write chunks",
+                                    roundStart / bandsPerRound );
+            for ( const auto & chunk : encoded )
+                this->writeChunk( chunk );
+            this->checkFile();
+        }
+    }
+
+    // Appends the shape of the chunks and the chunks row of chunks by
+    // row of chunks.
+    void appendFooter(
+            std::string & footer,
+            const std::vector<detail::ChunkEntry> & chunks ) const override
+    {
+        appendLittleEndian( footer, chunkRows, 8 );
+        appendLittleEndian( footer, chunkCols, 8 );
+        for ( const auto & chunk : chunks )
+            detail::appendChunkEntry( footer, chunk );
+    }
+
+    std::size_t chunkRows;
+    std::size_t chunkCols;
+};
+
+} // namespace conv
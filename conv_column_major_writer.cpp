@@ -0,0 +1,67 @@
+#include "conv_column_major_writer.h"
+
+#include "conv_encoding.h"
+
+#include "cpp_utils/exception.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace conv
+{
+
+namespace detail
+{
+
+std::string matrixMarketBanner( bool isInteger )
+{
+    return isInteger ? "%%MatrixMarket matrix array integer general\n"
+                     : "%%MatrixMarket matrix array real general\n";
+}
+
+
+std::string matrixMarketSizeLine( std::uint64_t nRows, std::uint64_t nCols )
+{
+    char line[64];
+    std::snprintf( line, sizeof(line), "%20llu %20llu\n",
+                   static_cast<unsigned long long>( nRows ),
+                   static_cast<unsigned long long>( nCols ) );
+    return line;
+}
+
+
+std::string mat4Header( bool isDouble, std::uint64_t nRows,
+                        std::uint64_t nCols )
+{
+    const std::uint64_t maxSize = std::numeric_limits<std::int32_t>::max();
+    if ( nRows > maxSize || nCols > maxSize )
+        CU_THROW( "A MAT-file cannot hold more than 2^31-1 rows or "
+                  "columns." );
+    // The values are written in the byte order of the processor, which
+    // the thousands digit of the type tells. The tens digit is the type
+    // of the values: 0 for double, 2 for int32.
+    const std::uint32_t type =
+            ( isLittleEndian() ? 0 : 1000 ) + ( isDouble ? 0 : 20 );
+    const char name[] = "matrix";
+    const std::uint32_t fields[5] = {
+        type,
+        static_cast<std::uint32_t>( nRows ),
+        static_cast<std::uint32_t>( nCols ),
+        0,                      // no imaginary part
+        sizeof(name) };
+    std::string header( sizeof(fields), '\0' );
+    std::memcpy( &header[0], fields, sizeof(fields) );
+    header.append( name, sizeof(name) );
+    return header;
+}
+
+
+void throwColumnMajorWriteError( const std::string & fileName )
+{
+    CU_THROW( "Failed to write the matrix to the file '" + fileName + "'." );
+}
+
+} // namespace detail
+
+} // namespace conv
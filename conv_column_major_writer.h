@@ -0,0 +1,201 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_matrix_view.h"
+#include "conv_matrix_writer.h"
+#include "conv_text_writer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace conv
+{
+
+namespace detail
+{
+
+// Returns the first line of a Matrix Market file.
+std::string matrixMarketBanner( bool isInteger );
+
+// Returns the line with the size of the matrix. It has the same length
+// for all sizes, so it can be overwritten when the size is known.
+std::string matrixMarketSizeLine( std::uint64_t nRows, std::uint64_t nCols );
+
+// Returns the header of a MATLAB Level 4 MAT-file with a matrix named
+// "matrix" of the given type. Its length does not depend on the size.
+std::string mat4Header( bool isDouble, std::uint64_t nRows,
+                        std::uint64_t nCols );
+
+void throwColumnMajorWriteError( const std::string & fileName );
+
+// Calls @c f for each block of contiguous values of the rows, which are
+// the values of the rows in order.
+template <typename T, typename F>
+void forEachContiguousBlock( const StridedView<T> & rows, F && f )
+{
+    if ( rows.rowStride() == rows.nCols() )
+        return f( StridedView<T>( &rows(0,0), rows.nRows() * rows.nCols(),
+                                  1, 1 ) );
+    for ( std::size_t i = 0; i < rows.nRows(); ++i )
+        f( StridedView<T>( &rows(i,0), rows.nCols(), 1, 1 ) );
+}
+
+} // namespace detail
+
+
+/// Writes a matrix in the array format of Matrix Market, i.e. a header
+/// with the size followed by the values column by column, one per line.
+/// Floating point numbers are written with as many digits as needed to
+/// read the same values back, see appendRoundTrip().
+///
+/// Since the values are stored column by column, each appended row is a
+/// column of the written matrix. The conversion therefore passes the rows
+/// of the transposed output. The size in the header is filled in by
+/// finish().
+template <typename T>
+class MatrixMarketWriter : public MatrixWriter<T>
+{
+public:
+    explicit MatrixMarketWriter( const std::string & fileName )
+        : fileName( fileName )
+        , file( fileName, std::ios::binary )
+    {
+        const auto header =
+                detail::matrixMarketBanner( std::is_integral<T>::value ) +
+                detail::matrixMarketSizeLine( 0, 0 );
+        file.write( header.data(), header.size() );
+        if ( !file.good() )
+            detail::throwColumnMajorWriteError( fileName );
+    }
+
+    void append( const StridedView<T> & columns ) override
+    {
+        if ( columns.nRows() == 0 )
+            return;
+        nRows = columns.nCols();
+        detail::forEachContiguousBlock( columns,
+                                        [&]( const StridedView<T> & values )
+        {
+            appendText<FloatNotation::RoundTrip>(
+                        values, file, fileName, nWrittenValues + 1,
+                        TrailingSpace::No );
+            nWrittenValues += values.nRows();
+        } );
+        nCols += columns.nRows();
+    }
+
+    void finish() override
+    {
+        const auto bannerSize = detail::matrixMarketBanner(
+                    std::is_integral<T>::value ).size();
+        const auto sizeLine = detail::matrixMarketSizeLine( nRows, nCols );
+        file.seekp( bannerSize );
+        file.write( sizeLine.data(), sizeLine.size() );
+        file.flush();
+        if ( !file.good() )
+            detail::throwColumnMajorWriteError( fileName );
+    }
+
+private:
+    std::string fileName;
+    std::ofstream file;
+    std::size_t nRows = 0;
+    std::size_t nCols = 0;
+    std::size_t nWrittenValues = 0;
+};
+
+
+/// Writes a matrix as a MATLAB Level 4 MAT-file, which MATLAB and Octave
+/// load as the variable "matrix".
+///
+/// Level 4 files are not limited in size like uncompressed Level 5 files,
+/// which hold at most 4 GB per variable. Doubles and 32 bit integers are
+/// stored as they are, 64 bit integers as doubles, since there is no such
+/// type in Level 4 files.
+///
+/// Like in MatrixMarketWriter, each appended row is a column of the
+/// written matrix.
+template <typename T>
+class Mat4Writer : public MatrixWriter<T>
+{
+public:
+    explicit Mat4Writer( const std::string & fileName )
+        : fileName( fileName )
+        , file( fileName, std::ios::binary )
+    {
+        const auto header = detail::mat4Header( isDouble, 0, 0 );
+        file.write( header.data(), header.size() );
+        if ( !file.good() )
+            detail::throwColumnMajorWriteError( fileName );
+    }
+
+    void append( const StridedView<T> & columns ) override
+    {
+        if ( columns.nRows() == 0 )
+            return;
+        nRows = columns.nCols();
+        detail::forEachContiguousBlock( columns,
+                                        [&]( const StridedView<T> & values )
+        {
+            write( &values(0,0), values.nRows() );
+        } );
+        nCols += columns.nRows();
+    }
+
+    void finish() override
+    {
+        const auto header = detail::mat4Header( isDouble, nRows, nCols );
+        file.seekp( 0 );
+        file.write( header.data(), header.size() );
+        file.flush();
+        if ( !file.good() )
+            detail::throwColumnMajorWriteError( fileName );
+    }
+
+private:
+    static const bool isDouble = !std::is_same<T, std::int32_t>::value;
+
+    void write( const double * values, std::size_t n )
+    {
+        file.write( reinterpret_cast<const char *>( values ),
+                    n * sizeof(double) );
+        if ( !file.good() )
+            detail::throwColumnMajorWriteError( fileName );
+    }
+
+    void write( const std::int32_t * values, std::size_t n )
+    {
+        file.write( reinterpret_cast<const char *>( values ),
+                    n * sizeof(std::int32_t) );
+        if ( !file.good() )
+            detail::throwColumnMajorWriteError( fileName );
+    }
+
+    void write( const std::int64_t * values, std::size_t n )
+    {
+        const std::size_t blockSize = 1 << 16;
+        std::vector<double> converted;
+        for ( std::size_t first = 0; first < n; first += blockSize )
+        {
+            const auto last = std::min( first + blockSize, n );
+            converted.assign( values + first, values + last );
+            write( converted.data(), converted.size() );
+        }
+    }
+
+    std::string fileName;
+    std::ofstream file;
+    std::size_t nRows = 0;
+    std::size_t nCols = 0;
+};
+
+} // namespace conv
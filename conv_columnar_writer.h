@@ -0,0 +1,145 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_chunk_file_writer.h"
+#include "conv_encoding.h"
+#include "conv_matrix_view.h"
+#include "conv_parallel.h"
+#include "conv_trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+namespace detail
+{
+
+// Maximum number of rows and of values of a row group.
+const std::size_t maxRowGroupRows = 1 << 16;
+const std::size_t maxRowGroupValues = 1 << 20;
+
+} // namespace detail
+
+
+/// Writes a matrix column by column, so that single columns can be read
+/// without decoding the rest of the file.
+///
+/// The rows are split into row groups of equal size, except for the last
+/// one. Each column of a row group is encoded as a chunk of its own by
+/// encodeSmallest(). The chunks are encoded in
+/// parallel and written in order of the row groups and, within a row
+/// group, of the columns. Rows which do not fill a row group are kept
+/// until more rows are appended, so small blocks of rows do not lead to
+/// small chunks.
+///
+/// All numbers are stored in little endian byte order:
+/// - 8 bytes "CMCOLS01"
+/// - the column chunks
+/// - the footer:
+///   - uint32 type of the values (1 for double, 2 for int32, 3 for int64)
+///   - uint32 padding
+///   - uint64 number of rows, uint64 number of columns and uint64 number
+///     of row groups
+///   - for each row group: uint64 number of rows, then for each column
+///     uint64 offset of the chunk in the file, uint64 size in bytes and
+///     uint32 ValueEncoding
+/// - uint64 size of the footer in bytes
+/// - 8 bytes "CMCOLS01"
+///
+/// A reader starts at the end of the file to find the footer.
+template <typename T>
+class ColumnarMatrixWriter : public ChunkFileWriter<T>
+{
+public:
+    explicit ColumnarMatrixWriter( const std::string & fileName )
+        : ChunkFileWriter<T>( fileName, "CMCOLS01", "columnar" )
+    {
+    }
+
+private:
+    std::size_t rowsPerBlock() const override
+    {
+        return std::min( detail::maxRowGroupValues /
+                         std::max<std::size_t>( this->nCols, 1 ),
+                         detail::maxRowGroupRows );
+    }
+
+    // Encodes and writes the rows as row groups of blockRows rows.
+    void writeBlocks( const StridedView<T> & rows ) override
+    {
+        const auto nCols = this->nCols;
+        const auto groupSize = this->blockRows;
+        const auto nGroups = ( rows.nRows() + groupSize - 1 ) / groupSize;
+        // The chunks of several row groups are encoded at once, so there
+        // is enough work for all threads even if there are few columns.
+        // The number of values per round limits the buffered output.
+        const std::size_t valuesPerRound = 1 << 22;
+        const auto groupsPerRound = std::max<std::size_t>(
+                    valuesPerRound / ( groupSize * nCols ), 1 );
+        std::vector<EncodedValues> encoded;
+        for ( std::size_t roundStart = 0; roundStart < nGroups;
+              roundStart += groupsPerRound )
+        {
+            const auto roundEnd =
+                    std::min( roundStart + groupsPerRound, nGroups );
+            encoded.assign( ( roundEnd - roundStart ) * nCols,
+                            EncodedValues() );
+            parallelFor( 0, encoded.size(), [&]( std::size_t k )
+            {
+                const auto group = roundStart + k / nCols;
+                const auto j = k % nCols;
+                const TraceScope trace( "encode column", j );
+                const auto first = group * groupSize;
+                const auto last = std::min( first + groupSize, rows.nRows() );
+                std::vector<T> column;
+                column.reserve( last - first );
+                for ( auto i = first; i != last; ++i )
+                    column.push_back( rows(i,j) );
+                encoded[k] = encodeSmallest( column.data(), column.size() );
+            } );
+            const TraceScope trace( "write columns",
+                                    roundStart / groupsPerRound );
+            for ( std::size_t k = 0; k < encoded.size(); ++k )
+            {
+                if ( k % nCols == 0 )
+                {
+                    const auto first = ( roundStart + k / nCols ) * groupSize;
+                    groupRows.push_back(
+                        std::min( first + groupSize, rows.nRows() ) - first );
+                }
+                this->writeChunk( encoded[k] );
+            }
+            this->checkFile();
+        }
+    }
+
+    // Appends the number of row groups and, for each row group, its
+    // number of rows and its chunks.
+    void appendFooter(
+            std::string & footer,
+            const std::vector<detail::ChunkEntry> & chunks ) const override
+    {
+        appendLittleEndian( footer, groupRows.size(), 8 );
+        for ( std::size_t group = 0; group < groupRows.size(); ++group )
+        {
+            appendLittleEndian( footer, groupRows[group], 8 );
+            for ( std::size_t j = 0; j < this->nCols; ++j )
+                detail::appendChunkEntry(
+                            footer, chunks[group*this->nCols + j] );
+        }
+    }
+
+    // number of rows of each row group
+    std::vector<std::uint64_t> groupRows;
+};
+
+} // namespace conv
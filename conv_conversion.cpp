@@ -0,0 +1,788 @@
+#include "conv_conversion.h"
+
+#include "conv_arrow_writer.h"
+#include "conv_chunked_writer.h"
+#include "conv_column_major_writer.h"
+#include "conv_columnar_writer.h"
+#include "conv_dense_matrix.h"
+#include "conv_fixed_width.h"
+#include "conv_header.h"
+#include "conv_mapped_file.h"
+#include "conv_missing_values.h"
+#include "conv_parse_errors.h"
+#include "conv_quantized_writer.h"
+#include "conv_row_reader.h"
+#include "conv_text_writer.h"
+#include "conv_thread_pool.h"
+#include "conv_trace.h"
+
+#include "cpp_utils/exception.h"
+#include "cpp_utils/more_algorithms.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace conv
+{
+
+namespace
+{
+
+// Number of characters which are checked at once by validate(). Since no
+// values are stored, a block only needs to keep all threads busy.
+const std::size_t validationBlockSize = 1 << 26;
+
+
+void throwIfEmpty( std::size_t nRows, const std::string & inputFileName )
+{
+    if ( nRows == 0 )
+        CU_THROW( "The file '" + inputFileName +
+                  "' does not contain samples." );
+}
+
+
+// Counts the missing values and bad lines the reader has found in the
+// whole matrix and writes their bitmap and report, if they are requested.
+// The bitmap follows the output, so it is transposed together with the
+// matrix.
+void reportReadProblems( const RowReader & reader,
+                         const ConversionOptions & options,
+                         ConversionReport & report )
+{
+    report.nMissingValues = reader.missingValues().size();
+    report.nBadLines = reader.parseErrors().size();
+    if ( !options.missingValueBitmapFileName.empty() )
+    {
+        const TraceScope trace( "write missing value bitmap" );
+        writeMissingValueBitmap( options.missingValueBitmapFileName,
+                                 reader.missingValues(), reader.nRows(),
+                                 reader.nCols(), options.shallTranspose );
+    }
+    if ( !options.errorReportFileName.empty() )
+    {
+        const TraceScope trace( "write error report" );
+        writeErrorReport( options.errorReportFileName,
+                          reader.parseErrors(), reader.nCols() );
+    }
+}
+
+
+// Runs @c f as a stage of the conversion. If requested, the hardware events
+// of the stage are counted and added to the counts of the stage with the
+// same name in the report.
+template <typename F>
+void runStage( const char * stage, const ConversionOptions & options,
+               ConversionReport & report, F && f )
+{
+    if ( !options.shallCountEvents )
+        return f();
+    PerfCounters counters;
+    counters.start();
+    f();
+    const auto counts = counters.stop();
+    auto & stages = report.stageCounts;
+    auto it = std::find_if( begin(stages), end(stages),
+                            [&]( const StageCounts & s )
+    {
+        return s.stage == stage;
+    } );
+    if ( it == end(stages) )
+    {
+        stages.push_back( StageCounts() );
+        stages.back().stage = stage;
+        it = end(stages) - 1;
+    }
+    it->counts += counts;
+}
+
+
+// Parses the whole matrix. The values are parsed directly from the mapped
+// file into the matrix, so no other copy of the input is held in memory.
+template <typename T>
+DenseMatrix<T> readMatrix( const MappedFile & file,
+                           const FileHeader & header,
+                           const FixedWidthLayout & layout,
+                           const ConversionOptions & options,
+                           ConversionReport & report )
+{
+    const TraceScope trace( "read matrix" );
+    DenseMatrix<T> matrix;
+    RowReader reader( file, header, layout, options.missingValues,
+                      options.badLines );
+    const auto nRows = reader.readRows<T>(
+                file.size(), [&]( std::size_t nRows, std::size_t nCols )
+    {
+        matrix = DenseMatrix<T>( nRows, nCols, options.hugePages );
+        return matrix.data();
+    } );
+    // Bad lines may have been dropped.
+    matrix.shrinkRows( nRows );
+    throwIfEmpty( reader.nRows(), file.fileName() );
+    reportReadProblems( reader, options, report );
+    return matrix;
+}
+
+
+// Maps row numbers to output file names.
+class FileNamePattern
+{
+public:
+    FileNamePattern( const std::string & outputFileNames,
+                     const std::string & replaceString )
+    {
+        if ( replaceString.empty() )
+            CU_THROW( "No characters to be replaced in the output file "
+                      "pattern have been specified." );
+        const auto it = cu::findBoyerMoore(
+                    begin(replaceString),
+                    end(replaceString),
+                    begin(outputFileNames),
+                    end(outputFileNames) );
+        if ( it == end(outputFileNames) )
+            CU_THROW( "Replacement characters could not be found "
+                      "in the output file pattern." );
+        firstPart = std::string( begin(outputFileNames), it );
+        lastPart = std::string( it+replaceString.size(),
+                                end(outputFileNames) );
+    }
+
+    std::string operator()( std::size_t rowNumber ) const
+    {
+        return firstPart + std::to_string(rowNumber) + lastPart;
+    }
+
+private:
+    std::string firstPart;
+    std::string lastPart;
+};
+
+
+// Returns the ranges of the values which are mapped to the integers by the
+// quantized output formats. If the range is not fixed, then it is
+// determined from the whole matrix.
+template <typename T>
+std::vector<ValueRange> quantizationRanges(
+        const Quantization & quantization, const StridedView<T> * matrix )
+{
+    if ( quantization.isRangeFixed )
+    {
+        if ( !( quantization.min < quantization.max ) )
+            CU_THROW( "The minimum of the quantization range must be "
+                      "less than its maximum." );
+        ValueRange range;
+        range.min = quantization.min;
+        range.max = quantization.max;
+        return { range };
+    }
+    if ( !matrix )
+        CU_THROW( "The range of the values can only be determined, if the "
+                  "matrix fits into the memory budget. Please specify a "
+                  "fixed quantization range." );
+    auto ranges = columnRanges( *matrix );
+    if ( !quantization.isPerColumn )
+        return { unite( ranges ) };
+    return ranges;
+}
+
+
+// Writes each row of the matrix to a file of its own, see
+// writeTextPerRow(). The notation of floating point numbers is chosen
+// here once for all values.
+template <typename T, bool isTransposed, typename F>
+void writeRowFiles( const StridedView<T, isTransposed> & matrix,
+                    F && fileNameOfRow, const ConversionOptions & options )
+{
+    if ( options.outputFormat == OutputFormat::HexFloatText )
+        writeTextPerRow<FloatNotation::Hex>( matrix, fileNameOfRow );
+    else
+        writeTextPerRow( matrix, fileNameOfRow );
+}
+
+
+// Creates the writer for the format of the single output file. The whole
+// matrix is given, if it is held in memory. The names of the columns are
+// written by the formats which support them.
+template <typename T>
+std::unique_ptr<MatrixWriter<T>> createWriter(
+        const ConversionOptions & options, const StridedView<T> * matrix,
+        const std::vector<std::string> & columnNames )
+{
+    const auto & fileName = options.outputFileNames;
+    switch ( options.outputFormat )
+    {
+    case OutputFormat::Text:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new TextMatrixWriter<T>( fileName, columnNames ) );
+    case OutputFormat::HexFloatText:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new TextMatrixWriter<T, FloatNotation::Hex>(
+                        fileName, columnNames ) );
+    case OutputFormat::Columnar:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new ColumnarMatrixWriter<T>( fileName ) );
+    case OutputFormat::Arrow:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new ArrowMatrixWriter<T>( fileName, columnNames ) );
+    case OutputFormat::Chunked:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new ChunkedMatrixWriter<T>( fileName ) );
+    case OutputFormat::MatrixMarket:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new MatrixMarketWriter<T>( fileName ) );
+    case OutputFormat::Mat4:
+        return std::unique_ptr<MatrixWriter<T>>(
+                    new Mat4Writer<T>( fileName ) );
+    case OutputFormat::QuantizedInt16:
+    case OutputFormat::QuantizedUInt8:
+        break;
+    }
+    const auto type = options.outputFormat == OutputFormat::QuantizedInt16
+            ? QuantizedType::Int16
+            : QuantizedType::UInt8;
+    return std::unique_ptr<MatrixWriter<T>>(
+                new QuantizedMatrixWriter<T>(
+                    fileName, type,
+                    quantizationRanges( options.quantization, matrix ),
+                    options.quantization.isPerColumn ) );
+}
+
+
+// Writes the whole matrix to the single output file.
+template <typename T>
+void writeSingleFile( const StridedView<T> & matrix,
+                      const ConversionOptions & options,
+                      const std::vector<std::string> & columnNames )
+{
+    const auto writer = createWriter( options, &matrix, columnNames );
+    writer->append( matrix );
+    writer->finish();
+}
+
+
+using Transpose = std::true_type;
+using DontTranspose = std::false_type;
+using FileForEachRow = std::true_type;
+using SingleFile = std::false_type;
+
+template <typename T>
+void writeMatrix( DenseMatrix<T> & matrix, const ConversionOptions & options,
+                  const std::vector<std::string> & columnNames,
+                  DontTranspose, SingleFile, ConversionReport & report )
+{
+    runStage( "format and write", options, report, [&]
+    {
+        const TraceScope trace( "write matrix" );
+        writeSingleFile( matrix.view(), options, columnNames );
+    } );
+}
+
+
+template <typename T>
+void writeMatrix( DenseMatrix<T> & matrix, const ConversionOptions & options,
+                  const std::vector<std::string> & columnNames,
+                  Transpose, SingleFile, ConversionReport & report )
+{
+    // The columns of an Arrow file are the rows of the parsed matrix,
+    // which are written as they are instead of transposing the matrix.
+    if ( options.outputFormat == OutputFormat::Arrow )
+    {
+        runStage( "format and write", options, report, [&]
+        {
+            const TraceScope trace( "write matrix" );
+            ArrowMatrixWriter<T> writer( options.outputFileNames,
+                                         columnNames );
+            writer.append( matrix.view().transposed() );
+            writer.finish();
+        } );
+        return;
+    }
+    runStage( "transpose", options, report, [&]
+    {
+        const TraceScope trace( "transpose" );
+        const auto start = std::chrono::steady_clock::now();
+        matrix.transpose();
+        report.transposeSeconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start ).count();
+    } );
+    runStage( "format and write", options, report, [&]
+    {
+        const TraceScope trace( "write matrix" );
+        writeSingleFile( matrix.view(), options, columnNames );
+    } );
+}
+
+
+template <typename T>
+void writeMatrix( DenseMatrix<T> & matrix, const ConversionOptions & options,
+                  const std::vector<std::string> &,
+                  DontTranspose, FileForEachRow, ConversionReport & report )
+{
+    const FileNamePattern fileNameOfRow( options.outputFileNames,
+                                         options.replaceString );
+    runStage( "format and write", options, report, [&]
+    {
+        const TraceScope trace( "write matrix" );
+        writeRowFiles( matrix.view(), fileNameOfRow, options );
+    } );
+}
+
+
+template <typename T>
+void writeMatrix( DenseMatrix<T> & matrix, const ConversionOptions & options,
+                  const std::vector<std::string> &,
+                  Transpose, FileForEachRow, ConversionReport & report )
+{
+    // Each output row of a transposed matrix is just a column of the
+    // parsed matrix. Hence the transposition is not carried out, but the
+    // columns are gathered while writing.
+    const FileNamePattern fileNameOfRow( options.outputFileNames,
+                                         options.replaceString );
+    runStage( "format and write", options, report, [&]
+    {
+        const TraceScope trace( "write matrix" );
+        writeRowFiles( matrix.view().transposed(), fileNameOfRow,
+                       options );
+    } );
+}
+
+
+// Writes consecutive blocks of output rows.
+template <typename T, typename FileMode>
+class RowBlockWriter;
+
+template <typename T>
+class RowBlockWriter<T, SingleFile>
+{
+public:
+    RowBlockWriter( const ConversionOptions & options,
+                    const std::vector<std::string> & columnNames )
+        : writer( createWriter<T>( options, nullptr, columnNames ) )
+    {
+    }
+
+    void write( const StridedView<T> & rows )
+    {
+        writer->append( rows );
+    }
+
+    void finish()
+    {
+        writer->finish();
+    }
+
+private:
+    std::unique_ptr<MatrixWriter<T>> writer;
+};
+
+template <typename T>
+class RowBlockWriter<T, FileForEachRow>
+{
+public:
+    RowBlockWriter( const ConversionOptions & options,
+                    const std::vector<std::string> & )
+        : options( options )
+        , fileNameOfRow( options.outputFileNames, options.replaceString )
+    {
+    }
+
+    void write( const StridedView<T> & rows )
+    {
+        const auto nRowsBefore = nWrittenRows;
+        writeRowFiles( rows, [&]( std::size_t rowNumber )
+        {
+            return fileNameOfRow( nRowsBefore + rowNumber );
+        }, options );
+        nWrittenRows += rows.nRows();
+    }
+
+    void finish()
+    {
+    }
+
+private:
+    const ConversionOptions & options;
+    FileNamePattern fileNameOfRow;
+    std::size_t nWrittenRows = 0;
+};
+
+
+// Parses blocks of rows and writes each of them before the next one is
+// parsed.
+template <typename T, typename Writer>
+void convertInBlocks( const MappedFile & file,
+                      const FileHeader & header,
+                      const FixedWidthLayout & layout,
+                      const MemoryPlan & plan, Writer & writer,
+                      const ConversionOptions & options,
+                      ConversionReport & report, DontTranspose )
+{
+    RowReader reader( file, header, layout, options.missingValues,
+                      options.badLines );
+    std::vector<T> values;
+    for ( std::size_t block = 0; !reader.atEnd(); ++block )
+    {
+        values.clear();
+        std::size_t nRows = 0;
+        runStage( "parse", options, report, [&]
+        {
+            const TraceScope trace( "read block", block );
+            nRows = reader.readRows( plan.blockSize, values );
+        } );
+        runStage( "format and write", options, report, [&]
+        {
+            const TraceScope trace( "write block", block );
+            writer.write( StridedView<T>(
+                              values.data(), nRows,
+                              reader.nCols(), reader.nCols() ) );
+        } );
+    }
+    throwIfEmpty( reader.nRows(), file.fileName() );
+    report.nValues = reader.nRows() * reader.nCols();
+    reportReadProblems( reader, options, report );
+}
+
+
+// Parses a band of columns in each pass over the file. The band is
+// transposed and written as the next rows of the output.
+template <typename T, typename Writer>
+void convertInBlocks( const MappedFile & file,
+                      const FileHeader & header,
+                      const FixedWidthLayout & layout,
+                      const MemoryPlan & plan, Writer & writer,
+                      const ConversionOptions & options,
+                      ConversionReport & report, Transpose )
+{
+    RowReader reader( file, header, layout, options.missingValues,
+                      options.badLines );
+    std::vector<T> values;
+    std::size_t firstCol = 0;
+    for ( std::size_t band = 0; ; ++band )
+    {
+        reader.rewind();
+        values.clear();
+        const auto lastCol =
+                firstCol + std::max<std::size_t>( plan.bandWidth, 1 );
+        runStage( "parse", options, report, [&]
+        {
+            const TraceScope trace( "read band", band );
+            while ( !reader.atEnd() )
+                reader.readRows( plan.blockSize, values, firstCol, lastCol );
+        } );
+        throwIfEmpty( reader.nRows(), file.fileName() );
+        const auto bandWidth = std::min( lastCol, reader.nCols() ) - firstCol;
+        runStage( "transpose", options, report, [&]
+        {
+            const TraceScope trace( "transpose band", band );
+            transposeInPlace( values.data(), reader.nRows(), bandWidth );
+        } );
+        runStage( "format and write", options, report, [&]
+        {
+            const TraceScope trace( "write band", band );
+            writer.write( StridedView<T>(
+                              values.data(), bandWidth,
+                              reader.nRows(), reader.nRows() ) );
+        } );
+        firstCol = lastCol;
+        if ( firstCol >= reader.nCols() )
+        {
+            report.nValues = reader.nRows() * reader.nCols();
+            reportReadProblems( reader, options, report );
+            return;
+        }
+    }
+}
+
+
+template <typename T, bool shallTranspose, bool shallCreateFileForEachRow>
+ConversionReport runPipeline( const MappedFile & file,
+                              const FileHeader & header,
+                              const FixedWidthLayout & layout,
+                              const FootprintEstimate & estimate,
+                              const ConversionOptions & options )
+{
+    const auto plan = planMemory( estimate, sizeof(T),
+                                  options.memoryBudget, shallTranspose );
+    ConversionReport report;
+    report.strategy = plan.strategy;
+    report.estimatedBytes = plan.estimatedBytes;
+    report.nInputBytes = file.size();
+    // The names belong to the columns of the input, which are the rows of
+    // the output, if it is transposed.
+    const auto columnNames = shallTranspose
+            ? std::vector<std::string>()
+            : header.columnNames;
+    if ( plan.strategy == MemoryStrategy::InMemory )
+    {
+        DenseMatrix<T> matrix;
+        runStage( "parse", options, report, [&]
+        {
+            matrix = readMatrix<T>( file, header, layout, options, report );
+        } );
+        report.hugePages = matrix.hugePages();
+        report.nValues = matrix.nRows() * matrix.nCols();
+        writeMatrix( matrix, options, columnNames,
+                     std::integral_constant<bool, shallTranspose>(),
+                     std::integral_constant<bool, shallCreateFileForEachRow>(),
+                     report );
+    }
+    else
+    {
+        RowBlockWriter<T, std::integral_constant<
+                bool, shallCreateFileForEachRow>> writer( options,
+                                                          columnNames );
+        convertInBlocks<T>( file, header, layout, plan, writer, options,
+                            report, std::integral_constant<bool,
+                                                           shallTranspose>() );
+        writer.finish();
+    }
+    return report;
+}
+
+
+using Pipeline = ConversionReport (*)( const MappedFile &,
+                                       const FileHeader &,
+                                       const FixedWidthLayout &,
+                                       const FootprintEstimate &,
+                                       const ConversionOptions & );
+
+template <typename T>
+Pipeline pipelineFor( bool shallTranspose, bool shallCreateFileForEachRow )
+{
+    static const Pipeline pipelines[2][2] = {
+        { &runPipeline<T, false, false>, &runPipeline<T, false, true> },
+        { &runPipeline<T, true,  false>, &runPipeline<T, true,  true> } };
+    return pipelines[shallTranspose][shallCreateFileForEachRow];
+}
+
+
+// Returns the pipeline for the type of the values and the options. The
+// writers of column-major formats get the columns of the output as rows,
+// so the pipeline transposes the parsed matrix exactly if the output is
+// not its transpose.
+Pipeline pipelineFor( NumberType numberType,
+                      const ConversionOptions & options )
+{
+    const auto isColumnMajor =
+            options.outputFormat == OutputFormat::MatrixMarket ||
+            options.outputFormat == OutputFormat::Mat4;
+    const auto shallTranspose = options.shallTranspose != isColumnMajor;
+    const auto shallCreateFileForEachRow = options.shallCreateFileForEachRow;
+    switch ( numberType )
+    {
+    case NumberType::Int32:
+        return pipelineFor<std::int32_t>( shallTranspose,
+                                          shallCreateFileForEachRow );
+    case NumberType::Int64:
+        return pipelineFor<std::int64_t>( shallTranspose,
+                                          shallCreateFileForEachRow );
+    default:
+        return pipelineFor<double>( shallTranspose,
+                                    shallCreateFileForEachRow );
+    }
+}
+
+
+// Returns the layout of the fields, if the values are in fixed-width
+// fields, or an empty layout otherwise.
+FixedWidthLayout layoutFor( const MappedFile & file,
+                            const FileHeader & header,
+                            const ConversionOptions & options )
+{
+    if ( !options.isFixedWidth )
+        return FixedWidthLayout();
+    if ( options.fieldWidths.empty() )
+        return detectFixedWidthLayout( file, header );
+    return fixedWidthLayout( file, header, options.fieldWidths );
+}
+
+
+// Throws, if the header contains the names of a different number of
+// columns than the first row contains values. Ragged rows may be longer
+// or shorter than the first row.
+void checkColumnNames( const MappedFile & file,
+                       const FileHeader & header,
+                       const FootprintEstimate & estimate,
+                       const ConversionOptions & options )
+{
+    if ( options.headerRules.hasColumnNames &&
+         options.missingValues.raggedRows == RaggedRows::Error &&
+         header.columnNames.size() != estimate.nCols )
+        CU_THROW( "The header of the file '" + file.fileName() + "' "
+                  "contains " + std::to_string( header.columnNames.size() ) +
+                  " names of columns, but the first row contains " +
+                  std::to_string( estimate.nCols ) + " values." );
+}
+
+
+// Parses all rows of the file to values of type @c T and discards them.
+// The reader parses all fields of a line, even if none of them is stored,
+// and bad lines are dropped, so that all of them are found. Only the
+// first @c maxErrors of them are kept.
+template <typename T>
+ValidationReport validateAs( const MappedFile & file,
+                             const FileHeader & header,
+                             const FixedWidthLayout & layout,
+                             const ConversionOptions & options,
+                             std::size_t maxErrors )
+{
+    RowReader reader( file, header, layout, options.missingValues,
+                      BadLines::Drop, maxErrors );
+    // storage of the empty rows
+    T ignored = 0;
+    for ( std::size_t block = 0; !reader.atEnd(); ++block )
+    {
+        const TraceScope trace( "validate block", block );
+        reader.readRows<T>( validationBlockSize,
+                            [&]( std::size_t, std::size_t )
+        {
+            return &ignored;
+        }, 0, 0 );
+    }
+    ValidationReport report;
+    report.nRows = reader.nRows();
+    report.nCols = reader.nCols();
+    report.nBadLines = reader.nParseErrors();
+    report.nEmptyLines = reader.nLines() - report.nRows - report.nBadLines;
+    report.firstErrors = reader.parseErrors();
+    return report;
+}
+
+
+ValidationReport validateAs( NumberType numberType,
+                             const MappedFile & file,
+                             const FileHeader & header,
+                             const FixedWidthLayout & layout,
+                             const ConversionOptions & options,
+                             std::size_t maxErrors )
+{
+    switch ( numberType )
+    {
+    case NumberType::Int32:
+        return validateAs<std::int32_t>( file, header, layout, options,
+                                         maxErrors );
+    case NumberType::Int64:
+        return validateAs<std::int64_t>( file, header, layout, options,
+                                         maxErrors );
+    default:
+        return validateAs<double>( file, header, layout, options,
+                                   maxErrors );
+    }
+}
+
+
+// Runs the pipeline for the type of the values. If the type has been
+// detected from the beginning of the file, but a value further down does
+// not fit into it, then the conversion is repeated with floating point
+// numbers.
+ConversionReport runPipeline( const ConversionOptions & options )
+{
+    if ( options.outputFormat != OutputFormat::Text &&
+         options.outputFormat != OutputFormat::HexFloatText &&
+         options.shallCreateFileForEachRow )
+        CU_THROW( "Only text can be written to a file for each row." );
+    const MappedFile file( options.inputFileName );
+    const auto header = readHeader( file, options.headerRules );
+    const auto layout = layoutFor( file, header, options );
+    const auto estimate = estimateFootprint( file, header, layout,
+                                             options.missingValues,
+                                             options.badLines );
+    checkColumnNames( file, header, estimate, options );
+    const auto numberType = options.numberType == NumberType::Detect
+            ? estimate.numberType
+            : options.numberType;
+    if ( numberType != NumberType::Double )
+    {
+        try
+        {
+            auto report = pipelineFor( numberType, options )(
+                        file, header, layout, estimate, options );
+            report.numberType = numberType;
+            return report;
+        }
+        catch ( const UnfitValueError & )
+        {
+            if ( options.numberType != NumberType::Detect )
+                throw;
+        }
+    }
+    auto report = pipelineFor( NumberType::Double, options )(
+                file, header, layout, estimate, options );
+    report.numberType = NumberType::Double;
+    return report;
+}
+
+} // unnamed namespace
+
+
+ConversionReport convert( const ConversionOptions & options )
+{
+    ThreadPool::instance().setThreadPinning( options.shallPinThreads );
+    if ( options.traceFileName.empty() )
+        return runPipeline( options );
+
+    // The trace of a failed conversion is written as well, since it
+    // might show what went wrong.
+    startTracing();
+    ConversionReport report;
+    try
+    {
+        report = runPipeline( options );
+    }
+    catch (...)
+    {
+        stopTracing();
+        writeTrace( options.traceFileName );
+        throw;
+    }
+    stopTracing();
+    writeTrace( options.traceFileName );
+    return report;
+}
+
+
+
+ValidationReport validate( const ConversionOptions & options,
+                           std::size_t maxErrors )
+{
+    ThreadPool::instance().setThreadPinning( options.shallPinThreads );
+    const MappedFile file( options.inputFileName );
+    const auto header = readHeader( file, options.headerRules );
+    const auto layout = layoutFor( file, header, options );
+    const auto estimate = estimateFootprint( file, header, layout,
+                                             options.missingValues,
+                                             BadLines::Drop );
+    checkColumnNames( file, header, estimate, options );
+
+    // Like a conversion, the check is repeated with floating point
+    // numbers, if a value does not fit into the detected type.
+    const auto numberType = options.numberType == NumberType::Detect
+            ? estimate.numberType
+            : options.numberType;
+    if ( numberType != NumberType::Double )
+    {
+        try
+        {
+            auto report = validateAs( numberType, file, header, layout,
+                                      options, maxErrors );
+            report.numberType = numberType;
+            return report;
+        }
+        catch ( const UnfitValueError & )
+        {
+            if ( options.numberType != NumberType::Detect )
+                throw;
+        }
+    }
+    auto report = validateAs( NumberType::Double, file, header, layout,
+                              options, maxErrors );
+    report.numberType = NumberType::Double;
+    return report;
+}
+
+} // namespace conv
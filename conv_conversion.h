@@ -0,0 +1,210 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_buffer.h"
+#include "conv_header.h"
+#include "conv_memory_plan.h"
+#include "conv_missing_values.h"
+#include "conv_parse_errors.h"
+#include "conv_perf_counters.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// Formats of the output files.
+enum class OutputFormat
+{
+    /// Each row is written as a line of numbers separated by spaces.
+    Text,
+    /// Like Text, but floating point numbers are written exactly in
+    /// hexadecimal notation, e.g. "0x1.8p+1". See appendHexFloat().
+    HexFloatText,
+    /// The values are mapped to 16 bit integers. See QuantizedMatrixWriter.
+    QuantizedInt16,
+    /// The values are mapped to 8 bit unsigned integers.
+    QuantizedUInt8,
+    /// The columns are compressed separately. See ColumnarMatrixWriter.
+    Columnar,
+    /// Arrow IPC file with a column for each matrix column.
+    Arrow,
+    /// Rectangular chunks are compressed separately. See
+    /// ChunkedMatrixWriter.
+    Chunked,
+    /// Matrix Market array file, a text format read by many numerical
+    /// tools.
+    MatrixMarket,
+    /// MATLAB Level 4 MAT-file with the matrix as variable "matrix".
+    Mat4,
+};
+
+
+/// Describes how the values are mapped to integers by the quantized
+/// output formats.
+struct Quantization
+{
+    /// Whether each column gets a scale and offset of its own instead of
+    /// a single pair for the whole matrix. With a fixed range the pairs of
+    /// all columns are the same.
+    bool isPerColumn = true;
+    /// Whether the range from @c min to @c max is mapped to the integers.
+    /// Otherwise the range of the values is determined before writing,
+    /// which needs the whole matrix in memory. Values outside the range
+    /// are clamped.
+    bool isRangeFixed = false;
+    double min = 0;
+    double max = 0;
+};
+
+
+/// Describes how a matrix file shall be converted.
+struct ConversionOptions
+{
+    std::string inputFileName;
+    /// Name of the output file or, if a file shall be created for each
+    /// row, the pattern of the output file names.
+    std::string outputFileNames;
+    /// Characters in the pattern of the output file names which are
+    /// replaced by the row numbers.
+    std::string replaceString;
+    bool shallTranspose = false;
+    bool shallCreateFileForEachRow = false;
+    /// Whether the worker threads are restricted to the CPUs of their
+    /// NUMA node, so they keep working on node-local memory.
+    bool shallPinThreads = false;
+    /// Kind of pages the matrix shall be stored in. If these are not
+    /// available, then ordinary pages are used.
+    HugePages hugePages = HugePages::None;
+    /// Number of bytes the conversion may use approximately. If the
+    /// matrix does not fit, then it is converted block by block. Zero
+    /// means no limit.
+    std::size_t memoryBudget = 0;
+    /// If not empty, the timeline of the conversion is recorded and
+    /// written to this file in the Chrome trace event format.
+    std::string traceFileName;
+    /// Whether hardware events like cycles and cache misses are counted
+    /// for each stage of the conversion.
+    bool shallCountEvents = false;
+    /// Type the values are parsed to. Integers are parsed and formatted
+    /// a lot faster than floating point numbers and need less memory.
+    NumberType numberType = NumberType::Detect;
+    /// Whether the values are in fields of fixed widths at the same
+    /// positions in each line instead of being separated by spaces.
+    bool isFixedWidth = false;
+    /// Widths of the fixed-width fields in characters. If empty, then they
+    /// are detected from the first lines. See detectFixedWidthLayout().
+    std::vector<std::size_t> fieldWidths;
+    /// Which lines at the beginning of the input file are skipped. The
+    /// names of the columns in the header are written to text and Arrow
+    /// files, unless the matrix is transposed.
+    HeaderRules headerRules;
+    /// Whether fields like "NA" or blank fixed-width fields are accepted
+    /// as missing values, what is stored instead and what happens to rows
+    /// of different lengths.
+    MissingValueRules missingValues;
+    /// If not empty, then a bitmap of the missing values of the output
+    /// matrix is written to this file. See writeMissingValueBitmap().
+    std::string missingValueBitmapFileName;
+    /// Whether lines which cannot be parsed abort the conversion or are
+    /// dropped or filled. The latter are lenient modes.
+    BadLines badLines = BadLines::Abort;
+    /// If not empty, then the lines which have been dropped or filled are
+    /// listed in this file. See writeErrorReport().
+    std::string errorReportFileName;
+    /// Only text can be written to a file for each row.
+    OutputFormat outputFormat = OutputFormat::Text;
+    Quantization quantization;
+};
+
+
+/// Hardware events counted during a stage of a conversion.
+struct StageCounts
+{
+    /// e.g. "parse", "transpose" or "format and write"
+    std::string stage;
+    PerfCounts counts;
+};
+
+
+/// Information about a finished conversion.
+struct ConversionReport
+{
+    /// Strategy which has been chosen to stay within the memory budget.
+    MemoryStrategy strategy = MemoryStrategy::InMemory;
+    /// Estimated peak memory consumption of the strategy.
+    std::size_t estimatedBytes = 0;
+    /// Kind of pages which actually backed the matrix.
+    HugePages hugePages = HugePages::None;
+    /// Type the values have been parsed to.
+    NumberType numberType = NumberType::Double;
+    /// Time spent on transposing the matrix in memory.
+    double transposeSeconds = 0;
+    /// Number of values in the matrix and size of the input file, by
+    /// which the counted events can be normalized.
+    std::size_t nValues = 0;
+    std::size_t nInputBytes = 0;
+    /// Number of values which have been filled in for missing values.
+    std::size_t nMissingValues = 0;
+    /// Number of lines which have been dropped or filled in a lenient
+    /// mode.
+    std::size_t nBadLines = 0;
+    /// Hardware events in the order of the stages, if they have been
+    /// counted. The counts are zero, if counting is not available.
+    std::vector<StageCounts> stageCounts;
+};
+
+/// Reads the matrix from the input file and writes it to the output
+/// file(s) as specified by the options.
+///
+/// The options are evaluated once at the start. Each combination of
+/// options and each type of values runs a pipeline which is compiled for
+/// exactly that combination, so the loops over rows and elements contain
+/// no checks of options. Before anything is parsed, the type of the
+/// values is detected and the memory consumption is estimated from the
+/// beginning of the input file, and a strategy is chosen which fits into
+/// the memory budget. Throws, if anything goes wrong. If the matrix is
+/// converted block by block, then errors in the input file might only be
+/// found after some output has been written.
+ConversionReport convert( const ConversionOptions & options );
+
+
+/// Result of a dry run of a conversion by validate().
+struct ValidationReport
+{
+    /// Type the values would be parsed to.
+    NumberType numberType = NumberType::Double;
+    /// Number of rows which can be converted and number of values in each
+    /// of them.
+    std::size_t nRows = 0;
+    std::size_t nCols = 0;
+    /// Number of blank lines after the header, which are skipped.
+    std::size_t nEmptyLines = 0;
+    /// Number of lines which cannot be parsed or contain a different
+    /// number of values than the first row.
+    std::size_t nBadLines = 0;
+    /// The first of these lines in the order of the file.
+    std::vector<ParseError> firstErrors;
+};
+
+/// Checks whether the input file can be converted with the options and
+/// finds the shape of the matrix without writing anything.
+///
+/// The file is parsed in parallel block by block like for a conversion,
+/// but no column is stored, so nothing is held in memory but the text of
+/// a block and no output file is touched. Bad lines do not stop the check.
+/// Up to @c maxErrors of them are reported with their positions. The
+/// rules for the header, missing values and ragged rows are taken from
+/// the options, so rows of different lengths are only bad lines, if ragged
+/// rows are errors. Throws, if the file cannot be read at all, e.g. if the
+/// names in the header do not fit the rows.
+ValidationReport validate( const ConversionOptions & options,
+                           std::size_t maxErrors = 100 );
+
+} // namespace conv
@@ -0,0 +1,76 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_buffer.h"
+#include "conv_matrix_view.h"
+#include "conv_transpose.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace conv
+{
+
+/// Matrix whose elements are stored contiguously in row-major order.
+template <typename T>
+class DenseMatrix
+{
+public:
+    DenseMatrix() = default;
+
+    /// Allocates a @c nRows x @c nCols matrix with uninitialized elements.
+    ///
+    /// The elements should be written with parallelForOnNodes() over the
+    /// rows, so that each row block is placed on the NUMA node which
+    /// processes it later.
+    DenseMatrix( std::size_t nRows, std::size_t nCols,
+                 HugePages hugePages = HugePages::None )
+        : rows( nRows )
+        , cols( nCols )
+        , elements( nRows * nCols, hugePages )
+    {
+    }
+
+    std::size_t nRows() const { return rows; }
+    std::size_t nCols() const { return cols; }
+
+    T * data() { return elements.data(); }
+    const T * data() const { return elements.data(); }
+
+    T * row( std::size_t i ) { return data() + i*cols; }
+    const T * row( std::size_t i ) const { return data() + i*cols; }
+
+    /// The kind of pages which backs the elements.
+    HugePages hugePages() const { return elements.hugePages(); }
+
+    StridedView<T> view() const
+    {
+        return StridedView<T>( data(), rows, cols, cols );
+    }
+
+    /// Keeps only the first @c nRows rows. Their memory is not released.
+    void shrinkRows( std::size_t nRows )
+    {
+        rows = std::min( rows, nRows );
+    }
+
+    /// Transposes the matrix in place. No second copy of the elements is
+    /// needed.
+    void transpose()
+    {
+        transposeInPlace( data(), rows, cols );
+        std::swap( rows, cols );
+    }
+
+private:
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    Buffer<T> elements;
+};
+
+} // namespace conv
@@ -0,0 +1,342 @@
+#include "conv_encoding.h"
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace conv
+{
+
+namespace
+{
+
+// Number of zero bits above the highest set bit. @c x must not be zero.
+unsigned countLeadingZeros( std::uint64_t x )
+{
+#ifdef __GNUC__
+    return static_cast<unsigned>( __builtin_clzll( x ) );
+#else
+    unsigned n = 0;
+    for ( ; !( x & ( std::uint64_t(1) << 63 ) ); x <<= 1 )
+        ++n;
+    return n;
+#endif
+}
+
+// Number of zero bits below the lowest set bit. @c x must not be zero.
+unsigned countTrailingZeros( std::uint64_t x )
+{
+#ifdef __GNUC__
+    return static_cast<unsigned>( __builtin_ctzll( x ) );
+#else
+    unsigned n = 0;
+    for ( ; !( x & 1 ); x >>= 1 )
+        ++n;
+    return n;
+#endif
+}
+
+
+// Appends bits to a string, the most significant bit of each byte first.
+class BitWriter
+{
+public:
+    explicit BitWriter( std::string & out )
+        : out( out )
+    {
+    }
+
+    // Writes the lowest @c n bits of @c bits.
+    void write( std::uint64_t bits, unsigned n )
+    {
+        if ( n > 32 )
+        {
+            write( bits >> 32, n - 32 );
+            write( bits, 32 );
+            return;
+        }
+        // At most 7 bits are pending, so 32 more still fit.
+        const auto mask = ( std::uint64_t(1) << n ) - 1;
+        pending = ( pending << n ) | ( bits & mask );
+        nPending += n;
+        while ( nPending >= 8 )
+        {
+            nPending -= 8;
+            out += char( ( pending >> nPending ) & 0xFF );
+        }
+        pending &= ( std::uint64_t(1) << nPending ) - 1;
+    }
+
+    // Pads the last byte with zeros.
+    void flush()
+    {
+        if ( nPending > 0 )
+            out += char( ( pending << ( 8 - nPending ) ) & 0xFF );
+        pending = 0;
+        nPending = 0;
+    }
+
+private:
+    std::string & out;
+    std::uint64_t pending = 0;
+    unsigned nPending = 0;
+};
+
+
+std::uint32_t read32( const char * p )
+{
+    std::uint32_t x;
+    std::memcpy( &x, p, sizeof(x) );
+    return x;
+}
+
+
+// Appends the remainder of a length which does not fit into the four bits
+// of an LZ4 token.
+void appendLz4Length( std::string & out, std::size_t length )
+{
+    for ( ; length >= 255; length -= 255 )
+        out += char( 255 );
+    out += char( length );
+}
+
+
+// Appends an LZ4 sequence of literals followed by a match. A match length
+// of zero marks the last sequence, which only consists of literals.
+void appendLz4Sequence( std::string & out, const char * literals,
+                        std::size_t nLiterals, std::size_t offset,
+                        std::size_t matchLength )
+{
+    const auto extraMatch = matchLength ? matchLength - 4 : 0;
+    out += char( ( ( nLiterals < 15 ? nLiterals : 15 ) << 4 ) |
+                 ( extraMatch < 15 ? extraMatch : 15 ) );
+    if ( nLiterals >= 15 )
+        appendLz4Length( out, nLiterals - 15 );
+    out.append( literals, nLiterals );
+    if ( matchLength == 0 )
+        return;
+    out += char( offset & 0xFF );
+    out += char( offset >> 8 );
+    if ( extraMatch >= 15 )
+        appendLz4Length( out, extraMatch - 15 );
+}
+
+
+// Returns the bytes of the values in little endian byte order.
+template <typename T>
+std::string plainBytes( const T * values, std::size_t n )
+{
+    std::string bytes( n * sizeof(T), '\0' );
+    if ( isLittleEndian() )
+    {
+        std::memcpy( &bytes[0], values, bytes.size() );
+        return bytes;
+    }
+    bytes.clear();
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        typename std::conditional<sizeof(T) == 4,
+                std::uint32_t, std::uint64_t>::type bits;
+        std::memcpy( &bits, &values[i], sizeof(bits) );
+        appendLittleEndian( bytes, bits, sizeof(bits) );
+    }
+    return bytes;
+}
+
+
+// Replaces the result by the candidate, if the candidate is smaller.
+void keepSmaller( EncodedValues & result, ValueEncoding encoding,
+                  std::string & candidate )
+{
+    if ( candidate.size() >= result.bytes.size() )
+        return;
+    result.encoding = encoding;
+    result.bytes.swap( candidate );
+}
+
+
+template <typename T>
+EncodedValues encodeShuffled( const T * values, std::size_t n )
+{
+    EncodedValues result;
+    result.bytes = plainBytes( values, n );
+    std::string shuffled;
+    shuffleBytes( result.bytes.data(), n, sizeof(T), shuffled );
+    std::string compressed;
+    compressLz4( shuffled.data(), shuffled.size(), compressed );
+    keepSmaller( result, ValueEncoding::ShuffleLz4, compressed );
+    return result;
+}
+
+} // unnamed namespace
+
+
+void appendLittleEndian( std::string & out, std::uint64_t value,
+                         std::size_t nBytes )
+{
+    for ( std::size_t i = 0; i < nBytes; ++i )
+        out += char( ( value >> ( 8*i ) ) & 0xFF );
+}
+
+
+void appendLittleEndian( std::string & out, double value )
+{
+    std::uint64_t bits = 0;
+    std::memcpy( &bits, &value, sizeof(bits) );
+    appendLittleEndian( out, bits, sizeof(bits) );
+}
+
+
+bool isLittleEndian()
+{
+    const std::uint16_t one = 1;
+    std::uint8_t firstByte = 0;
+    std::memcpy( &firstByte, &one, 1 );
+    return firstByte == 1;
+}
+
+
+void encodeDelta( const std::int64_t * values, std::size_t n,
+                  std::string & out )
+{
+    std::uint64_t previous = 0;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        // Unsigned arithmetic wraps around instead of overflowing.
+        const auto value = static_cast<std::uint64_t>( values[i] );
+        const auto difference = value - previous;
+        previous = value;
+        auto zigzag = ( difference << 1 ) ^ ( 0 - ( difference >> 63 ) );
+        for ( ; zigzag >= 0x80; zigzag >>= 7 )
+            out += char( ( zigzag & 0x7F ) | 0x80 );
+        out += char( zigzag );
+    }
+}
+
+
+void encodeXor( const double * values, std::size_t n, std::string & out )
+{
+    BitWriter bits( out );
+    std::uint64_t previous = 0;
+    // Meaningful bits of the last XOR which has been stored with them.
+    unsigned leading = 64;
+    unsigned trailing = 64;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        std::uint64_t value;
+        std::memcpy( &value, &values[i], sizeof(value) );
+        const auto x = value ^ previous;
+        previous = value;
+        if ( x == 0 )
+        {
+            bits.write( 0, 1 );
+            continue;
+        }
+        auto newLeading = countLeadingZeros( x );
+        const auto newTrailing = countTrailingZeros( x );
+        if ( newLeading >= leading && newTrailing >= trailing )
+        {
+            bits.write( 2, 2 );
+            bits.write( x >> trailing, 64 - leading - trailing );
+            continue;
+        }
+        // Five bits only hold up to 31 leading zeros.
+        if ( newLeading > 31 )
+            newLeading = 31;
+        leading = newLeading;
+        trailing = newTrailing;
+        const auto nMeaningful = 64 - leading - trailing;
+        bits.write( 3, 2 );
+        bits.write( leading, 5 );
+        bits.write( nMeaningful & 63, 6 );
+        bits.write( x >> trailing, nMeaningful );
+    }
+    bits.flush();
+}
+
+
+void shuffleBytes( const char * values, std::size_t n, std::size_t valueSize,
+                   std::string & out )
+{
+    const auto start = out.size();
+    out.resize( start + n * valueSize );
+    auto dest = &out[start];
+    for ( std::size_t k = 0; k < valueSize; ++k )
+        for ( std::size_t i = 0; i < n; ++i )
+            *dest++ = values[i*valueSize + k];
+}
+
+
+void compressLz4( const char * data, std::size_t size, std::string & out )
+{
+    // The format requires the last five bytes to be literals and the last
+    // match to start at least twelve bytes before the end.
+    const std::size_t lastLiterals = 5;
+    const std::size_t matchStartLimit = 12;
+    const std::size_t maxOffset = 65535;
+    const unsigned hashBits = 16;
+    std::size_t anchor = 0;
+    if ( size > matchStartLimit )
+    {
+        // Positions plus one, so zero means no entry.
+        std::vector<std::uint32_t> table( std::size_t(1) << hashBits, 0 );
+        const auto matchEndLimit = size - lastLiterals;
+        std::size_t pos = 0;
+        while ( pos + matchStartLimit <= size )
+        {
+            const auto sequence = read32( data + pos );
+            const auto hash = ( sequence * 2654435761u ) >> ( 32 - hashBits );
+            const std::size_t candidate = table[hash];
+            table[hash] = static_cast<std::uint32_t>( pos + 1 );
+            if ( candidate == 0 || pos - ( candidate - 1 ) > maxOffset ||
+                 read32( data + candidate - 1 ) != sequence )
+            {
+                ++pos;
+                continue;
+            }
+            const auto match = candidate - 1;
+            auto length = std::size_t(4);
+            while ( pos + length < matchEndLimit &&
+                    data[match + length] == data[pos + length] )
+                ++length;
+            appendLz4Sequence( out, data + anchor, pos - anchor,
+                               pos - match, length );
+            pos += length;
+            anchor = pos;
+        }
+    }
+    appendLz4Sequence( out, data + anchor, size - anchor, 0, 0 );
+}
+
+
+EncodedValues encodeSmallest( const double * values, std::size_t n )
+{
+    auto result = encodeShuffled( values, n );
+    std::string bytes;
+    encodeXor( values, n, bytes );
+    keepSmaller( result, ValueEncoding::Xor, bytes );
+    return result;
+}
+
+
+EncodedValues encodeSmallest( const std::int32_t * values, std::size_t n )
+{
+    auto result = encodeShuffled( values, n );
+    const std::vector<std::int64_t> wide( values, values + n );
+    std::string bytes;
+    encodeDelta( wide.data(), n, bytes );
+    keepSmaller( result, ValueEncoding::Delta, bytes );
+    return result;
+}
+
+
+EncodedValues encodeSmallest( const std::int64_t * values, std::size_t n )
+{
+    auto result = encodeShuffled( values, n );
+    std::string bytes;
+    encodeDelta( values, n, bytes );
+    keepSmaller( result, ValueEncoding::Delta, bytes );
+    return result;
+}
+
+} // namespace conv
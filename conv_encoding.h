@@ -0,0 +1,99 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace conv
+{
+
+/// Appends the lowest @c nBytes bytes of the integer to @c out in little
+/// endian byte order.
+void appendLittleEndian( std::string & out, std::uint64_t value,
+                         std::size_t nBytes );
+
+/// Appends the bits of the floating point number to @c out in little
+/// endian byte order.
+void appendLittleEndian( std::string & out, double value );
+
+/// Whether the processor stores numbers in little endian byte order.
+bool isLittleEndian();
+
+
+/// Appends the differences between consecutive integers to @c out.
+///
+/// The first value is taken as the difference to zero. Each difference is
+/// mapped to an unsigned number by zigzag encoding (0, -1, 1, -2, ... to
+/// 0, 1, 2, 3, ...) and stored as a little endian base 128 varint, i.e.
+/// seven bits per byte with the high bit set on all but the last byte.
+/// Slowly changing integers take one or two bytes each.
+void encodeDelta( const std::int64_t * values, std::size_t n,
+                  std::string & out );
+
+
+/// Appends floating point numbers to @c out compressed by the XOR scheme
+/// of Facebook's Gorilla time series database.
+///
+/// The bits of each value are XORed with the bits of the previous one.
+/// The result is written to a bit stream (most significant bit of each
+/// byte first) as
+/// - '0', if it is zero,
+/// - '10' and the meaningful bits, if they lie within the meaningful
+///   bits of the previous stored XOR,
+/// - '11', five bits for the number of leading zeros, six bits for the
+///   number of meaningful bits (0 meaning 64) and the meaningful bits.
+///
+/// The first value is XORed with zero. Neighbouring values with similar
+/// exponents and few significant digits compress best.
+void encodeXor( const double * values, std::size_t n, std::string & out );
+
+
+/// Appends @c n values of @c valueSize bytes each to @c out with their
+/// bytes regrouped: the first bytes of all values, then the second bytes
+/// and so on. Bytes which hardly change, like the exponents of floating
+/// point numbers, end up next to each other, which helps compression.
+void shuffleBytes( const char * values, std::size_t n, std::size_t valueSize,
+                   std::string & out );
+
+
+/// Ways a sequence of values can be encoded. See encodeSmallest().
+enum class ValueEncoding
+{
+    /// The values in little endian byte order.
+    Plain = 0,
+    /// Integers only, see encodeDelta().
+    Delta = 1,
+    /// Floating point numbers only, see encodeXor().
+    Xor = 2,
+    /// The bytes of the plain encoding regrouped by shuffleBytes() and
+    /// compressed by compressLz4().
+    ShuffleLz4 = 3,
+};
+
+struct EncodedValues
+{
+    ValueEncoding encoding = ValueEncoding::Plain;
+    std::string bytes;
+};
+
+/// Encodes the values with each encoding which suits the type and returns
+/// the smallest result.
+EncodedValues encodeSmallest( const double * values, std::size_t n );
+EncodedValues encodeSmallest( const std::int32_t * values, std::size_t n );
+EncodedValues encodeSmallest( const std::int64_t * values, std::size_t n );
+
+
+/// Appends the bytes compressed in the LZ4 block format to @c out.
+///
+/// Matches are found greedily with a hash table of four byte sequences,
+/// which is the fast mode of the reference implementation. The result can
+/// be decompressed by @c LZ4_decompress_safe() given the original size.
+/// The size must be less than 4 GB.
+void compressLz4( const char * data, std::size_t size, std::string & out );
+
+} // namespace conv
@@ -0,0 +1,403 @@
+#include "conv_fixed_width.h"
+
+#include "conv_mapped_file.h"
+#include "conv_parallel.h"
+#include "conv_parsing.h"
+#include "conv_row_reader.h"
+#include "conv_trace.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace conv
+{
+
+namespace
+{
+
+// Maximum number of lines from which the layout is detected.
+const std::size_t maxSampledLines = 100;
+
+// Minimum number of fields which are parsed by a single task.
+const std::size_t minFieldsPerTask = 1 << 14;
+
+// Marks that no faulty line has been found.
+const std::size_t noError = std::numeric_limits<std::size_t>::max();
+
+// Returns the first character after the header.
+const char * dataBegin( const MappedFile & file, const FileHeader & header )
+{
+    return file.begin() + header.size;
+}
+
+
+// Returns a layout without fields whose line length is the one of the
+// first line after the header. Text without line break is a single line.
+FixedWidthLayout firstLineLayout( const MappedFile & file,
+                                  const FileHeader & header )
+{
+    FixedWidthLayout layout;
+    const auto first = dataBegin( file, header );
+    const auto lineBreak = static_cast<const char *>(
+                std::memchr( first, '\n', file.end() - first ) );
+    if ( !lineBreak )
+    {
+        layout.lineLength = file.end() - first + 1;
+        return layout;
+    }
+    layout.lineLength = lineBreak + 1 - first;
+    if ( lineBreak != first && lineBreak[-1] == '\r' )
+        layout.lineBreakLength = 2;
+    return layout;
+}
+
+
+// Returns whether the line which starts at @c line ends with a line break
+// at the position given by the layout.
+bool hasLineBreak( const char * line, const FixedWidthLayout & layout )
+{
+    return line[layout.lineLength - 1] == '\n' &&
+            ( layout.lineBreakLength == 1 ||
+              line[layout.lineLength - 2] == '\r' );
+}
+
+
+// Returns the one-based number of the line of a row in the file for
+// messages.
+std::string lineNumber( const FileHeader & header, std::size_t row )
+{
+    return std::to_string( header.nLines + row + 1 );
+}
+
+} // unnamed namespace
+
+
+FixedWidthLayout fixedWidthLayout( const MappedFile & file,
+                                   const FileHeader & header,
+                                   const std::vector<std::size_t> & widths )
+{
+    auto layout = firstLineLayout( file, header );
+    std::size_t offset = 0;
+    for ( const auto width : widths )
+    {
+        if ( width == 0 )
+            CU_THROW( "The widths of the fields must be positive." );
+        layout.offsets.push_back( offset );
+        layout.widths.push_back( width );
+        offset += width;
+    }
+    if ( offset > layout.lineLength - layout.lineBreakLength )
+        CU_THROW( "The fields of the given widths do not fit into line " +
+                  lineNumber( header, 0 ) + " of the file '" +
+                  file.fileName() + "'." );
+    return layout;
+}
+
+
+FixedWidthLayout detectFixedWidthLayout( const MappedFile & file,
+                                         const FileHeader & header )
+{
+    auto layout = firstLineLayout( file, header );
+    const auto lineLength = layout.lineLength - layout.lineBreakLength;
+    const auto nRows = nFixedWidthRows( file, header, layout );
+    const auto nSampledLines = std::min( nRows, maxSampledLines );
+
+    // Mark the positions where values start and end in the first line.
+    // They must be the same in the other lines for the values to be
+    // aligned to the left or to the right, respectively.
+    std::vector<char> starts( lineLength + 1 );
+    std::vector<char> ends( lineLength + 1 );
+    bool isLeftAligned = true;
+    bool isRightAligned = true;
+    for ( std::size_t i = 0; i < nSampledLines; ++i )
+    {
+        const auto line = dataBegin( file, header ) + i * layout.lineLength;
+        if ( i + 1 < nRows && !hasLineBreak( line, layout ) )
+            CU_THROW( "Line " + lineNumber( header, i ) + " in file '" +
+                      file.fileName() + "' does not have the length of "
+                      "the first line." );
+        for ( std::size_t pos = 0; pos <= lineLength; ++pos )
+        {
+            const auto isValue = pos < lineLength && !isSeparator( line[pos] );
+            const auto wasValue = pos > 0 && !isSeparator( line[pos-1] );
+            const char isStart = isValue && !wasValue;
+            const char isEnd = wasValue && !isValue;
+            if ( i == 0 )
+            {
+                starts[pos] = isStart;
+                ends[pos] = isEnd;
+            }
+            isLeftAligned = isLeftAligned && starts[pos] == isStart;
+            isRightAligned = isRightAligned && ends[pos] == isEnd;
+        }
+    }
+    if ( !isLeftAligned && !isRightAligned )
+        CU_THROW( "The values at the beginning of the file '" +
+                  file.fileName() + "' are not aligned in columns. "
+                  "Please specify the widths of the fields." );
+
+    // Right aligned fields reach from the end of the previous value to
+    // the end of their value, left aligned fields from the start of their
+    // value to the start of the next one.
+    std::vector<std::size_t> boundaries;
+    for ( std::size_t pos = 0; pos <= lineLength; ++pos )
+        if ( isRightAligned ? ends[pos] : starts[pos] )
+            boundaries.push_back( pos );
+    if ( boundaries.empty() )
+        CU_THROW( "Line " + lineNumber( header, 0 ) + " of the file '" +
+                  file.fileName() + "' does not contain any values." );
+    if ( isRightAligned )
+        boundaries.insert( begin(boundaries), 0 );
+    else
+        boundaries.push_back( lineLength );
+    for ( std::size_t j = 0; j + 1 < boundaries.size(); ++j )
+    {
+        layout.offsets.push_back( boundaries[j] );
+        layout.widths.push_back( boundaries[j+1] - boundaries[j] );
+    }
+    return layout;
+}
+
+
+std::size_t nFixedWidthRows( const MappedFile & file,
+                             const FileHeader & header,
+                             const FixedWidthLayout & layout )
+{
+    const auto size = file.size() - header.size;
+    if ( size % layout.lineLength == 0 )
+        return size / layout.lineLength;
+    // The last line has no line break.
+    if ( ( size + layout.lineBreakLength ) % layout.lineLength == 0 )
+        return ( size + layout.lineBreakLength ) / layout.lineLength;
+    CU_THROW( "The lines of the file '" + file.fileName() + "' do not all "
+              "have the length of the first line." );
+}
+
+
+template <typename T>
+std::size_t readFixedWidthRows( const MappedFile & file,
+                                const FileHeader & header,
+                                const FixedWidthLayout & layout,
+                                const MissingValueRules & missingValueRules,
+                                BadLines badLines,
+                                std::size_t firstRow, std::size_t lastRow,
+                                std::size_t firstCol, std::size_t lastCol,
+                                T * values,
+                                std::vector<MissingValue> & missingValues,
+                                std::vector<ParseError> & parseErrors )
+{
+    if ( firstRow >= lastRow )
+        return 0;
+    const auto nRows = lastRow - firstRow;
+    const auto width = lastCol - firstCol;
+    T fillValue = 0;
+    const auto canFill = fillMissingValue( missingValueRules, fillValue );
+    const auto isLenient = badLines != BadLines::Abort;
+    const auto canReplace = badLines == BadLines::Drop ||
+            ( badLines == BadLines::Fill && canFill );
+
+    // The lenient modes check all fields, so that each pass over a band
+    // of columns drops the same rows and finds all errors.
+    const auto firstParsedCol = isLenient ? 0 : firstCol;
+    const auto lastParsedCol = isLenient ? layout.widths.size() : lastCol;
+    const auto nCols = lastParsedCol - firstParsedCol;
+    if ( nCols == 0 )
+        return nRows;
+
+    // The rows are split among the tasks first. The columns are split as
+    // well, if there are fewer rows than tasks, e.g. for a few long rows.
+    const auto nTasks = std::max<std::size_t>( std::min<std::size_t>(
+                4 * ThreadPool::instance().nThreads(),
+                nRows * nCols / minFieldsPerTask ), 1 );
+    const auto nRowPieces = std::min( nRows, nTasks );
+    const auto nColPieces =
+            std::min( nCols, ( nTasks + nRowPieces - 1 ) / nRowPieces );
+
+    // The first faulty field of each task. Errors are thrown afterwards,
+    // so that the first one in the file is reported.
+    struct Error
+    {
+        std::size_t row = noError;
+        std::size_t col = 0;
+        bool isLineBreakMissing = false;
+        // whether the field is a number which does not fit into T
+        bool isUnfit = false;
+    };
+    std::vector<Error> errors( nRowPieces * nColPieces );
+    // Missing values and replaced fields of each task. The rows of the
+    // missing values are counted from the first row.
+    std::vector<std::vector<MissingValue>> missing( errors.size() );
+    std::vector<std::vector<ParseError>> replaced( errors.size() );
+    parallelForOnNodes( 0, errors.size(), [&]( std::size_t k )
+    {
+        const TraceScope trace( "parse fields", k );
+        const auto rowPiece = k / nColPieces;
+        const auto colPiece = k % nColPieces;
+        const auto pieceFirstRow = firstRow + nRows * rowPiece / nRowPieces;
+        const auto pieceLastRow =
+                firstRow + nRows * ( rowPiece + 1 ) / nRowPieces;
+        const auto pieceFirstCol =
+                firstParsedCol + nCols * colPiece / nColPieces;
+        const auto pieceLastCol =
+                firstParsedCol + nCols * ( colPiece + 1 ) / nColPieces;
+        auto & error = errors[k];
+        // target of the fields outside the band
+        T ignored = 0;
+        for ( auto i = pieceFirstRow; i != pieceLastRow; ++i )
+        {
+            const auto line =
+                    dataBegin( file, header ) + i * layout.lineLength;
+            if ( colPiece == 0 &&
+                 ( i + 1 ) * layout.lineLength <= file.size() - header.size &&
+                 !hasLineBreak( line, layout ) )
+            {
+                error.row = i;
+                error.isLineBreakMissing = true;
+                return;
+            }
+            const auto row = values + ( i - firstRow ) * width - firstCol;
+            for ( auto j = pieceFirstCol; j != pieceLastCol; ++j )
+            {
+                const auto isInBand = j >= firstCol && j < lastCol;
+                auto & target = isInBand ? row[j] : ignored;
+                const auto value = fieldValue( line, layout, j );
+                if ( parseNumber( value.first, value.second, target ) )
+                    continue;
+                const auto kind = classifyNonNumber(
+                            value.first, value.second, missingValueRules,
+                            target );
+                if ( kind == NonNumber::Missing )
+                {
+                    if ( isInBand )
+                        missing[k].push_back( { i - firstRow, j } );
+                    continue;
+                }
+                if ( kind == NonNumber::Invalid && canReplace )
+                {
+                    // Only the first field of a line is reported.
+                    target = fillValue;
+                    if ( isInBand && badLines == BadLines::Fill )
+                        missing[k].push_back( { i - firstRow, j } );
+                    if ( replaced[k].empty() ||
+                         replaced[k].back().line != i )
+                        replaced[k].push_back( {
+                            ParseErrorKind::NotANumber, i, j + 1,
+                            std::size_t( value.first - file.begin() ),
+                            layout.widths.size() } );
+                    continue;
+                }
+                // A lenient mode only gets here, if the fill value does
+                // not fit into T.
+                error.row = i;
+                error.col = j;
+                error.isUnfit = kind == NonNumber::Unfit || isLenient;
+                return;
+            }
+        }
+    } );
+
+    const auto error = std::min_element(
+                begin(errors), end(errors),
+                []( const Error & lhs, const Error & rhs )
+    {
+        return lhs.row != rhs.row ? lhs.row < rhs.row : lhs.col < rhs.col;
+    } );
+    if ( error->row != noError )
+    {
+        const auto where = "Field " + std::to_string( error->col + 1 ) +
+                " of line " + lineNumber( header, error->row ) +
+                " in file '" + file.fileName() + "'";
+        if ( error->isLineBreakMissing )
+            CU_THROW( "Line " + lineNumber( header, error->row ) +
+                      " in file '" + file.fileName() + "' does not have "
+                      "the length of the first line." );
+        if ( error->isUnfit )
+            throw UnfitValueError( where + " is not " +
+                                   describeValue( T() ) + "." );
+        CU_THROW( where + " is not a number." );
+    }
+
+    // Several tasks may have found errors in the same line. Only the first
+    // one is kept.
+    std::vector<ParseError> lineErrors;
+    for ( const auto & piece : replaced )
+        lineErrors.insert( end(lineErrors), begin(piece), end(piece) );
+    std::sort( begin(lineErrors), end(lineErrors),
+               []( const ParseError & lhs, const ParseError & rhs )
+    {
+        return lhs.line != rhs.line ? lhs.line < rhs.line
+                                    : lhs.column < rhs.column;
+    } );
+    lineErrors.erase( std::unique( begin(lineErrors), end(lineErrors),
+                                   []( const ParseError & lhs,
+                                       const ParseError & rhs )
+    {
+        return lhs.line == rhs.line;
+    } ), end(lineErrors) );
+
+    // Dropped rows are removed by moving the following rows down.
+    std::vector<MissingValue> blockMissing;
+    for ( const auto & piece : missing )
+        blockMissing.insert( end(blockMissing), begin(piece), end(piece) );
+    std::size_t nStoredRows = nRows;
+    if ( badLines == BadLines::Drop && !lineErrors.empty() )
+    {
+        std::vector<std::size_t> newRows( nRows );
+        nStoredRows = 0;
+        auto lineError = begin(lineErrors);
+        for ( std::size_t i = 0; i < nRows; ++i )
+        {
+            if ( lineError != end(lineErrors) &&
+                 lineError->line == firstRow + i )
+            {
+                newRows[i] = noError;
+                ++lineError;
+                continue;
+            }
+            if ( nStoredRows != i )
+                std::copy( values + i * width, values + ( i + 1 ) * width,
+                           values + nStoredRows * width );
+            newRows[i] = nStoredRows++;
+        }
+        blockMissing.erase( std::remove_if(
+                                begin(blockMissing), end(blockMissing),
+                                [&]( const MissingValue & missingValue )
+        {
+            return newRows[missingValue.row] == noError;
+        } ), end(blockMissing) );
+        for ( auto & missingValue : blockMissing )
+            missingValue.row = newRows[missingValue.row];
+    }
+    missingValues.insert( end(missingValues),
+                          begin(blockMissing), end(blockMissing) );
+    for ( auto lineError : lineErrors )
+    {
+        lineError.line += header.nLines + 1;
+        parseErrors.push_back( lineError );
+    }
+    return nStoredRows;
+}
+
+
+template std::size_t readFixedWidthRows<double>(
+        const MappedFile &, const FileHeader &, const FixedWidthLayout &,
+        const MissingValueRules &, BadLines, std::size_t, std::size_t,
+        std::size_t, std::size_t, double *, std::vector<MissingValue> &,
+        std::vector<ParseError> & );
+template std::size_t readFixedWidthRows<std::int32_t>(
+        const MappedFile &, const FileHeader &, const FixedWidthLayout &,
+        const MissingValueRules &, BadLines, std::size_t, std::size_t,
+        std::size_t, std::size_t, std::int32_t *,
+        std::vector<MissingValue> &, std::vector<ParseError> & );
+template std::size_t readFixedWidthRows<std::int64_t>(
+        const MappedFile &, const FileHeader &, const FixedWidthLayout &,
+        const MissingValueRules &, BadLines, std::size_t, std::size_t,
+        std::size_t, std::size_t, std::int64_t *,
+        std::vector<MissingValue> &, std::vector<ParseError> & );
+
+} // namespace conv
@@ -0,0 +1,116 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_header.h"
+#include "conv_missing_values.h"
+#include "conv_parse_errors.h"
+#include "conv_parsing.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace conv
+{
+
+class MappedFile;
+
+/// Positions of the values in a file whose lines consist of fields of
+/// fixed widths.
+///
+/// All lines after the header have the same length, so the field @c j of
+/// the line @c i starts at the character @c i*lineLength+offsets[j] after
+/// the header. An empty layout means that the values are separated by
+/// spaces instead.
+struct FixedWidthLayout
+{
+    /// Position of each field within a line.
+    std::vector<std::size_t> offsets;
+    /// Number of characters of each field.
+    std::vector<std::size_t> widths;
+    /// Number of characters of a line including its line break.
+    std::size_t lineLength = 0;
+    /// Number of characters of the line break, i.e. 2 for "\r\n".
+    std::size_t lineBreakLength = 1;
+
+    bool isEmpty() const { return widths.empty(); }
+};
+
+
+/// Returns the characters of the field @c j of the line which starts at
+/// @c line without the separators around the value.
+inline std::pair<const char *, const char *> fieldValue(
+        const char * line, const FixedWidthLayout & layout, std::size_t j )
+{
+    auto first = line + layout.offsets[j];
+    auto last = first + layout.widths[j];
+    while ( first != last && isSeparator( *first ) )
+        ++first;
+    while ( last != first && isSeparator( last[-1] ) )
+        --last;
+    return { first, last };
+}
+
+
+/// Returns the layout of the file, if its lines after the header consist
+/// of fields of the given widths. The length of the lines is taken from
+/// the first line after the header.
+///
+/// Throws, if the fields do not fit into that line.
+FixedWidthLayout fixedWidthLayout( const MappedFile & file,
+                                   const FileHeader & header,
+                                   const std::vector<std::size_t> & widths );
+
+/// Detects the layout of the file from the first lines after the header.
+///
+/// The values must be separated by spaces in these lines and be aligned
+/// either to the right or to the left, so that all values of a column end
+/// or start at the same position. Throws, if this is not the case.
+FixedWidthLayout detectFixedWidthLayout( const MappedFile & file,
+                                         const FileHeader & header );
+
+/// Returns the number of lines after the header of a file with the layout.
+///
+/// Throws, if the size of the file is not a multiple of the line length.
+/// The last line need not have a line break.
+std::size_t nFixedWidthRows( const MappedFile & file,
+                             const FileHeader & header,
+                             const FixedWidthLayout & layout );
+
+/// Parses the fields @c [firstCol,lastCol) of the lines @c [firstRow,lastRow)
+/// after the header and stores them row by row in @c values.
+///
+/// Since the position of each field is known, any rows can be read without
+/// scanning the lines before them, and the fields are fetched without
+/// searching for line breaks and separators. Both the rows and the columns
+/// are split among the threads, so even a few rows are parsed in parallel.
+///
+/// Blank fields and other missing values are filled according to the
+/// rules and their positions are appended to @c missingValues with the
+/// rows counted from the first stored row.
+///
+/// In the lenient modes for bad lines, the first field of each line which
+/// is not a number is appended to @c parseErrors, and the line is either
+/// filled or left out. Returns the number of stored rows.
+///
+/// @c T can be @c double, @c std::int32_t or @c std::int64_t. Throws, if a
+/// field is not a number in the strict mode or if a line break is not
+/// where it should be. Throws UnfitValueError, if a value does not fit
+/// into @c T.
+template <typename T>
+std::size_t readFixedWidthRows( const MappedFile & file,
+                                const FileHeader & header,
+                                const FixedWidthLayout & layout,
+                                const MissingValueRules & missingValueRules,
+                                BadLines badLines,
+                                std::size_t firstRow, std::size_t lastRow,
+                                std::size_t firstCol, std::size_t lastCol,
+                                T * values,
+                                std::vector<MissingValue> & missingValues,
+                                std::vector<ParseError> & parseErrors );
+
+} // namespace conv
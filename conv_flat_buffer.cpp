@@ -0,0 +1,143 @@
+#include "conv_flat_buffer.h"
+
+#include "conv_encoding.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+
+namespace conv
+{
+
+FlatBufferBuilder::Field FlatBufferBuilder::scalar(
+        std::uint16_t id, std::uint64_t value, std::size_t size )
+{
+    Field field{ id, std::string() };
+    appendLittleEndian( field.bytes, value, size );
+    return field;
+}
+
+
+FlatBufferBuilder::Field FlatBufferBuilder::offset( std::uint16_t id )
+{
+    return Field{ id, std::string( 4, '\0' ) };
+}
+
+
+FlatBufferBuilder::FlatBufferBuilder()
+    : buffer( 4, '\0' )
+{
+}
+
+
+FlatBufferBuilder::Table FlatBufferBuilder::addTable(
+        std::vector<Field> fields )
+{
+    // Larger fields first keeps all of them aligned.
+    std::vector<std::size_t> order( fields.size() );
+    for ( std::size_t k = 0; k < order.size(); ++k )
+        order[k] = k;
+    std::stable_sort( begin(order), end(order),
+                      [&]( std::size_t a, std::size_t b )
+    {
+        return fields[a].bytes.size() > fields[b].bytes.size();
+    } );
+    std::size_t nIds = 0;
+    std::size_t tableSize = 4;
+    for ( const auto & field : fields )
+    {
+        nIds = std::max<std::size_t>( nIds, field.id + 1 );
+        tableSize += field.bytes.size();
+    }
+    std::vector<std::uint16_t> fieldOffsets( nIds, 0 );
+    std::size_t fieldOffset = 4;
+    for ( const auto k : order )
+    {
+        fieldOffsets[fields[k].id] =
+                static_cast<std::uint16_t>( fieldOffset );
+        fieldOffset += fields[k].bytes.size();
+    }
+
+    pad( 2 );
+    const auto vtable = buffer.size();
+    appendLittleEndian( buffer, 4 + 2*nIds, 2 );
+    appendLittleEndian( buffer, tableSize, 2 );
+    for ( const auto offset : fieldOffsets )
+        appendLittleEndian( buffer, offset, 2 );
+    // The eight byte fields follow the four byte offset to the vtable.
+    pad( 8, 4 );
+    Table table;
+    table.position = buffer.size();
+    appendLittleEndian( buffer, table.position - vtable, 4 );
+    table.fields.resize( fields.size() );
+    for ( const auto k : order )
+    {
+        table.fields[k] = buffer.size();
+        buffer += fields[k].bytes;
+    }
+    return table;
+}
+
+
+std::size_t FlatBufferBuilder::addStructVector( const std::string & elements,
+                                                std::size_t nElements )
+{
+    pad( 8, 4 );
+    const auto position = buffer.size();
+    appendLittleEndian( buffer, nElements, 4 );
+    buffer += elements;
+    return position;
+}
+
+
+std::size_t FlatBufferBuilder::addOffsetVector( std::size_t nElements )
+{
+    pad( 4 );
+    const auto position = buffer.size();
+    appendLittleEndian( buffer, nElements, 4 );
+    buffer.append( 4 * nElements, '\0' );
+    return position;
+}
+
+
+std::size_t FlatBufferBuilder::addString( const std::string & s )
+{
+    pad( 4 );
+    const auto position = buffer.size();
+    appendLittleEndian( buffer, s.size(), 4 );
+    buffer += s;
+    buffer += '\0';
+    return position;
+}
+
+
+void FlatBufferBuilder::link( std::size_t at, std::size_t target )
+{
+    if ( target <= at || at + 4 > buffer.size() )
+        CU_THROW( "Invalid offset in a FlatBuffer." );
+    std::string bytes;
+    appendLittleEndian( bytes, target - at, 4 );
+    buffer.replace( at, 4, bytes );
+}
+
+
+void FlatBufferBuilder::setRoot( const Table & table )
+{
+    link( 0, table.position );
+}
+
+
+std::string FlatBufferBuilder::finish()
+{
+    pad( 8 );
+    return buffer;
+}
+
+
+void FlatBufferBuilder::pad( std::size_t alignment, std::size_t remainder )
+{
+    while ( buffer.size() % alignment != remainder )
+        buffer += '\0';
+}
+
+} // namespace conv
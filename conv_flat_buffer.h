@@ -0,0 +1,89 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// Builds a FlatBuffer, the serialization format of the Arrow metadata,
+/// without the FlatBuffers library.
+///
+/// Unlike the library, the buffer is built front to back: An object which
+/// is referred to by an offset must be added after the object containing
+/// the offset, since offsets are unsigned. The offsets are filled in by
+/// link() once the position of the referenced object is known.
+///
+/// Each table is preceded by its vtable. The fields of a table are sorted
+/// by size, so all of them are aligned, if the buffer starts at a multiple
+/// of eight bytes.
+class FlatBufferBuilder
+{
+public:
+    /// Field of a table with its value in little endian byte order.
+    /// Offsets to other objects are four zero bytes to be filled in by
+    /// link().
+    struct Field
+    {
+        std::uint16_t id;
+        std::string bytes;
+    };
+
+    /// Returns a field holding an integer of @c size bytes.
+    static Field scalar( std::uint16_t id, std::uint64_t value,
+                         std::size_t size );
+
+    /// Returns a field holding an offset to another object.
+    static Field offset( std::uint16_t id );
+
+    /// Position of a table and of its fields in the order they have been
+    /// passed to addTable().
+    struct Table
+    {
+        std::size_t position;
+        std::vector<std::size_t> fields;
+    };
+
+    /// Starts the buffer with the offset to the root table, which is set
+    /// by setRoot().
+    FlatBufferBuilder();
+
+    Table addTable( std::vector<Field> fields );
+
+    /// Adds a vector of structs, which are given in their binary layout
+    /// with eight byte alignment, and returns its position.
+    std::size_t addStructVector( const std::string & elements,
+                                 std::size_t nElements );
+
+    /// Adds a vector of offsets to tables and returns its position. The
+    /// offset of element @c k lies at the returned position + 4 + 4k.
+    std::size_t addOffsetVector( std::size_t nElements );
+
+    /// Adds a zero terminated string and returns its position.
+    std::size_t addString( const std::string & s );
+
+    /// Lets the offset at position @c at refer to the object at position
+    /// @c target.
+    void link( std::size_t at, std::size_t target );
+
+    void setRoot( const Table & table );
+
+    /// Returns the buffer padded to a multiple of eight bytes.
+    std::string finish();
+
+private:
+    // Appends zeros until the size of the buffer is @c remainder modulo
+    // @c alignment.
+    void pad( std::size_t alignment, std::size_t remainder = 0 );
+
+    std::string buffer;
+};
+
+} // namespace conv
@@ -0,0 +1,133 @@
+#include "conv_formatting.h"
+
+#include "conv_parsing.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+
+namespace conv
+{
+
+namespace
+{
+
+const char hexDigits[] = "0123456789abcdef";
+
+// The decimal digits of the numbers from 0 to 99.
+const char digitPairs[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+} // unnamed namespace
+
+
+void appendNumber( std::string & out, double value )
+{
+    char buffer[32];
+    const auto n = std::snprintf( buffer, sizeof(buffer), "%g", value );
+    // Qt applications may run with a locale whose decimal point differs
+    // from the one in the classic locale std::ostream uses.
+    const auto decimalPoint = *std::localeconv()->decimal_point;
+    if ( decimalPoint != '.' )
+        std::replace( buffer, buffer + n, decimalPoint, '.' );
+    out.append( buffer, n );
+}
+
+
+void appendRoundTrip( std::string & out, double value )
+{
+    char buffer[32];
+    auto n = 0;
+    // 17 significant digits always suffice, but mostly fewer do, which
+    // are shorter, since trailing zeros are omitted.
+    for ( auto precision = 15; precision <= 17; ++precision )
+    {
+        n = std::snprintf( buffer, sizeof(buffer), "%.*g", precision,
+                           value );
+        const auto decimalPoint = *std::localeconv()->decimal_point;
+        if ( decimalPoint != '.' )
+            std::replace( buffer, buffer + n, decimalPoint, '.' );
+        double parsed;
+        if ( parseDouble( buffer, buffer + n, parsed ) && parsed == value )
+            break;
+    }
+    out.append( buffer, n );
+}
+
+
+void appendNumber( std::string & out, std::int64_t value )
+{
+    // 19 digits and a sign
+    char buffer[20];
+    auto p = buffer + sizeof(buffer);
+    auto magnitude = value < 0 ? 0 - std::uint64_t( value )
+                               : std::uint64_t( value );
+    while ( magnitude >= 100 )
+    {
+        p -= 2;
+        std::memcpy( p, digitPairs + 2 * ( magnitude % 100 ), 2 );
+        magnitude /= 100;
+    }
+    if ( magnitude >= 10 )
+    {
+        p -= 2;
+        std::memcpy( p, digitPairs + 2 * magnitude, 2 );
+    }
+    else
+        *--p = char( '0' + magnitude );
+    if ( value < 0 )
+        *--p = '-';
+    out.append( p, buffer + sizeof(buffer) );
+}
+
+
+void appendNumber( std::string & out, std::int32_t value )
+{
+    appendNumber( out, std::int64_t( value ) );
+}
+
+
+void appendHexFloat( std::string & out, double value )
+{
+    std::uint64_t bits;
+    std::memcpy( &bits, &value, sizeof(bits) );
+    const auto biasedExponent = int( ( bits >> 52 ) & 0x7FF );
+    auto fraction = bits & 0xFFFFFFFFFFFFF;
+    if ( biasedExponent == 0x7FF )
+        return appendNumber( out, value );
+    // Like printf, subnormal numbers are written with the exponent of the
+    // smallest normal numbers and a leading 0 instead of a leading 1.
+    const auto exponent = biasedExponent != 0 ? biasedExponent - 1023
+                        : fraction != 0       ? -1022
+                        : 0;
+    // sign, "0x1.", 13 hexadecimal digits, "p" and the exponent's sign
+    char buffer[24];
+    auto p = buffer;
+    if ( bits >> 63 )
+        *p++ = '-';
+    *p++ = '0';
+    *p++ = 'x';
+    *p++ = biasedExponent != 0 ? '1' : '0';
+    if ( fraction != 0 )
+    {
+        *p++ = '.';
+        // The 52 bits of the fraction are 13 hexadecimal digits, of which
+        // the trailing zeros are omitted.
+        for ( int shift = 48; fraction != 0; shift -= 4 )
+        {
+            *p++ = hexDigits[ ( fraction >> shift ) & 0xF ];
+            fraction &= ( std::uint64_t(1) << shift ) - 1;
+        }
+    }
+    *p++ = 'p';
+    *p++ = exponent < 0 ? '-' : '+';
+    out.append( buffer, p );
+    appendNumber( out, std::int32_t( exponent < 0 ? -exponent : exponent ) );
+}
+
+} // namespace conv
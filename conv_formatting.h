@@ -0,0 +1,85 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace conv
+{
+
+/// Notations of floating point numbers in text.
+enum class FloatNotation
+{
+    /// Six significant decimal digits, see appendNumber().
+    Decimal,
+    /// Hexadecimal mantissa and binary exponent, see appendHexFloat().
+    Hex,
+    /// As many decimal digits as needed to read the same value back, see
+    /// appendRoundTrip().
+    RoundTrip,
+};
+
+
+/// Appends the value to @c out formatted like @c std::ostream does by
+/// default, i.e. with six significant digits.
+///
+/// The decimal point is always a '.' regardless of the locale of the
+/// program.
+void appendNumber( std::string & out, double value );
+
+/// Appends the decimal digits of the integer to @c out.
+///
+/// Two digits at a time are taken from a table, which is several times
+/// faster than formatting a floating point number.
+void appendNumber( std::string & out, std::int64_t value );
+void appendNumber( std::string & out, std::int32_t value );
+
+/// Appends the value to @c out exactly in hexadecimal notation, like
+/// @c printf does for "%a", e.g. "0x1.8p+1" for 3 and "-0x1p-2" for -0.25.
+///
+/// The hexadecimal digits are the bits of the mantissa, so no decimal
+/// conversion and no rounding takes place. Parsing the text with
+/// parseDouble() yields the same value again. Infinities and NaNs are
+/// written like by appendNumber().
+void appendHexFloat( std::string & out, double value );
+
+/// Appends the value to @c out in decimal notation with the fewest of 15,
+/// 16 or 17 significant digits which yield the same value again when the
+/// text is parsed with parseDouble(), e.g. "0.1" and not
+/// "0.10000000000000001".
+///
+/// Like for appendNumber(), the decimal point is always a '.'.
+void appendRoundTrip( std::string & out, double value );
+
+/// Appends the value to @c out in the given notation. The notation is a
+/// template parameter, so that it is chosen once for a whole matrix and
+/// not for each value. Integers are always written in decimal, since they
+/// are exact anyway.
+template <FloatNotation notation>
+inline void appendNumber( std::string & out, double value )
+{
+    switch ( notation )
+    {
+    case FloatNotation::Decimal:   return appendNumber( out, value );
+    case FloatNotation::Hex:       return appendHexFloat( out, value );
+    case FloatNotation::RoundTrip: return appendRoundTrip( out, value );
+    }
+}
+
+template <FloatNotation notation>
+inline void appendNumber( std::string & out, std::int64_t value )
+{
+    appendNumber( out, value );
+}
+
+template <FloatNotation notation>
+inline void appendNumber( std::string & out, std::int32_t value )
+{
+    appendNumber( out, value );
+}
+
+} // namespace conv
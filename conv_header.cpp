@@ -0,0 +1,82 @@
+#include "conv_header.h"
+
+#include "conv_mapped_file.h"
+#include "conv_parsing.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace conv
+{
+
+namespace
+{
+
+// Returns the end of the line which starts at @c p excluding the line
+// break.
+const char * lineEnd( const char * p, const char * last )
+{
+    const auto lineBreak = static_cast<const char *>(
+                std::memchr( p, '\n', last - p ) );
+    return lineBreak ? lineBreak : last;
+}
+
+
+// Returns whether the line is blank or starts with the comment prefix
+// after leading separators.
+bool isCommentOrBlank( const char * first, const char * last,
+                       const std::string & commentPrefix )
+{
+    while ( first != last && isSeparator( *first ) )
+        ++first;
+    return first == last ||
+            ( !commentPrefix.empty() &&
+              std::size_t( last - first ) >= commentPrefix.size() &&
+              std::equal( begin(commentPrefix), end(commentPrefix), first ) );
+}
+
+} // unnamed namespace
+
+
+FileHeader readHeader( const MappedFile & file, const HeaderRules & rules )
+{
+    FileHeader header;
+    auto p = file.begin();
+    const auto nextLine = [&]
+    {
+        p = lineEnd( p, file.end() );
+        if ( p != file.end() )
+            ++p;
+        ++header.nLines;
+    };
+    const auto skipComments = [&]
+    {
+        while ( p != file.end() &&
+                isCommentOrBlank( p, lineEnd( p, file.end() ),
+                                  rules.commentPrefix ) )
+            nextLine();
+    };
+
+    while ( header.nLines < rules.nSkippedLines && p != file.end() )
+        nextLine();
+    skipComments();
+    if ( rules.hasColumnNames )
+    {
+        if ( p == file.end() )
+            CU_THROW( "The file '" + file.fileName() + "' does not contain "
+                      "a line with the names of the columns." );
+        forEachToken( p, lineEnd( p, file.end() ),
+                      [&]( const char * first, const char * last )
+        {
+            header.columnNames.emplace_back( first, last );
+        } );
+        nextLine();
+        skipComments();
+    }
+    header.size = p - file.begin();
+    return header;
+}
+
+} // namespace conv
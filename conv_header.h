@@ -0,0 +1,53 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+class MappedFile;
+
+/// Describes the lines at the beginning of a matrix file which are not
+/// rows of the matrix.
+struct HeaderRules
+{
+    /// Number of lines at the beginning of the file which are skipped.
+    std::size_t nSkippedLines = 0;
+    /// Lines which start with this prefix are skipped after those. Empty
+    /// for no comments.
+    std::string commentPrefix;
+    /// Whether the first line after the skipped lines and comments
+    /// contains the names of the columns separated by spaces.
+    bool hasColumnNames = false;
+};
+
+
+/// Lines at the beginning of a matrix file which precede the rows.
+struct FileHeader
+{
+    /// Number of characters of the header, i.e. the position of the first
+    /// line after it.
+    std::size_t size = 0;
+    /// Number of lines of the header.
+    std::size_t nLines = 0;
+    /// Names of the columns, if the rules say the header contains them.
+    std::vector<std::string> columnNames;
+};
+
+/// Finds the header of the file according to the rules.
+///
+/// The header is determined once before the rows are parsed, so the
+/// parsers only ever see the lines after it and need not check each line
+/// for comments. Comment lines and blank lines before and after the line
+/// with the column names belong to the header. Comments further down in
+/// the file are not recognized.
+FileHeader readHeader( const MappedFile & file, const HeaderRules & rules );
+
+} // namespace conv
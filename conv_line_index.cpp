@@ -0,0 +1,77 @@
+#include "conv_line_index.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace conv
+{
+
+LineIndex::LineIndex( const char * first, const char * last )
+    : first( first )
+    , last( last )
+    , scanPos( first )
+    , checkpoints( 1, first )
+{
+}
+
+
+void LineIndex::scanMore( std::size_t maxBytes )
+{
+    const auto scanEnd = static_cast<std::size_t>( last - scanPos ) < maxBytes
+            ? last : scanPos + maxBytes;
+    while ( scanPos != scanEnd )
+    {
+        const auto p = static_cast<const char *>(
+                    std::memchr( scanPos, '\n', scanEnd - scanPos ) );
+        if ( !p )
+        {
+            scanPos = scanEnd;
+            break;
+        }
+        scanPos = p + 1;
+        ++nLineBreaks;
+        if ( nLineBreaks % checkpointInterval == 0 )
+            checkpoints.push_back( scanPos );
+    }
+}
+
+
+bool LineIndex::isComplete() const
+{
+    return scanPos == last;
+}
+
+
+std::size_t LineIndex::nLines() const
+{
+    // A last line without terminating line break only counts, once it is
+    // known that no line break follows.
+    const bool hasUnterminatedLastLine =
+            isComplete() && first != last && last[-1] != '\n';
+    return nLineBreaks + ( hasUnterminatedLastLine ? 1 : 0 );
+}
+
+
+std::size_t LineIndex::nScannedBytes() const
+{
+    return scanPos - first;
+}
+
+
+std::pair<const char *, const char *> LineIndex::line( std::size_t i ) const
+{
+    assert( i < nLines() );
+    auto lineStart = checkpoints[i / checkpointInterval];
+    for ( auto n = i % checkpointInterval; n != 0; --n )
+        lineStart = static_cast<const char *>(
+                    std::memchr( lineStart, '\n', last - lineStart ) ) + 1;
+    auto lineEnd = static_cast<const char *>(
+                std::memchr( lineStart, '\n', last - lineStart ) );
+    if ( !lineEnd )
+        lineEnd = last;
+    if ( lineEnd != lineStart && lineEnd[-1] == '\r' )
+        --lineEnd;
+    return { lineStart, lineEnd };
+}
+
+} // namespace conv
@@ -0,0 +1,57 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace conv
+{
+
+/// Lazily built index of the lines in a range of characters.
+///
+/// Only the start of every @c checkpointInterval-th line is stored, so the
+/// memory consumption stays small even for files with billions of lines.
+/// The index is extended step by step through scanMore(), which makes it
+/// possible to show the beginning of a huge file without scanning all of
+/// it first.
+class LineIndex
+{
+public:
+    static const std::size_t checkpointInterval = 1024;
+
+    /// The characters must stay alive as long as the index is used.
+    LineIndex( const char * first, const char * last );
+
+    /// Scans at most @c maxBytes more characters for line breaks.
+    void scanMore( std::size_t maxBytes );
+
+    /// Returns whether the whole range has been scanned.
+    bool isComplete() const;
+
+    /// Returns the number of lines which have been found so far.
+    std::size_t nLines() const;
+
+    /// Returns the number of characters which have been scanned so far.
+    std::size_t nScannedBytes() const;
+
+    /// Returns the characters of the line with the given zero-based index
+    /// excluding the line break. Requires @c i < nLines().
+    std::pair<const char *, const char *> line( std::size_t i ) const;
+
+private:
+    const char * first;
+    const char * last;
+    // Position up to which line breaks have been searched.
+    const char * scanPos;
+    // Number of line breaks found before scanPos.
+    std::size_t nLineBreaks = 0;
+    // Start of the lines 0, checkpointInterval, 2*checkpointInterval, ...
+    std::vector<const char *> checkpoints;
+};
+
+} // namespace conv
@@ -0,0 +1,128 @@
+#include "conv_mapped_file.h"
+
+#include "cpp_utils/exception.h"
+#include "cpp_utils/std_make_unique.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CONV_HAS_MMAP 1
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+namespace conv
+{
+
+struct MappedFile::Impl
+{
+    std::string fileName;
+    const char * data = nullptr;
+    std::size_t size = 0;
+#ifdef CONV_HAS_MMAP
+    int fd = -1;
+#else
+    std::vector<char> buffer;
+#endif
+};
+
+
+MappedFile::MappedFile( const std::string & fileName )
+{
+    m = std::make_unique<Impl>();
+    m->fileName = fileName;
+#ifdef CONV_HAS_MMAP
+    m->fd = ::open( fileName.c_str(), O_RDONLY );
+    if ( m->fd == -1 )
+        CU_THROW( "Could not open the file '" + fileName + "'." );
+    struct stat info;
+    if ( ::fstat( m->fd, &info ) != 0 )
+    {
+        ::close( m->fd );
+        CU_THROW( "Could not determine the size of the file '" +
+                  fileName + "'." );
+    }
+    m->size = static_cast<std::size_t>( info.st_size );
+    if ( m->size == 0 ) // mmap() does not accept empty mappings.
+        return;
+    void * const p = ::mmap( nullptr, m->size, PROT_READ, MAP_PRIVATE,
+                             m->fd, 0 );
+    if ( p == MAP_FAILED )
+    {
+        ::close( m->fd );
+        CU_THROW( "Could not map the file '" + fileName + "' into memory." );
+    }
+    m->data = static_cast<const char *>( p );
+#else
+    std::ifstream file( fileName, std::ios::binary );
+    if ( !file )
+        CU_THROW( "Could not open the file '" + fileName + "'." );
+    m->buffer.assign( std::istreambuf_iterator<char>(file),
+                      std::istreambuf_iterator<char>() );
+    if ( file.bad() )
+        CU_THROW( "The file '" + fileName + "' could not be read." );
+    m->data = m->buffer.data();
+    m->size = m->buffer.size();
+#endif
+}
+
+
+MappedFile::~MappedFile()
+{
+#ifdef CONV_HAS_MMAP
+    if ( m->data )
+        ::munmap( const_cast<char *>( m->data ), m->size );
+    ::close( m->fd );
+#endif
+}
+
+
+const char * MappedFile::begin() const
+{
+    return m->data;
+}
+
+
+const char * MappedFile::end() const
+{
+    return m->data + m->size;
+}
+
+
+std::size_t MappedFile::size() const
+{
+    return m->size;
+}
+
+
+const std::string & MappedFile::fileName() const
+{
+    return m->fileName;
+}
+
+
+void MappedFile::release( const char * first, const char * last ) const
+{
+#ifdef CONV_HAS_MMAP
+    // Only whole pages can be released.
+    const auto pageSize =
+            static_cast<std::uintptr_t>( ::sysconf( _SC_PAGESIZE ) );
+    const auto pageFirst = ( reinterpret_cast<std::uintptr_t>( first ) +
+                             pageSize - 1 ) / pageSize * pageSize;
+    const auto pageLast =
+            reinterpret_cast<std::uintptr_t>( last ) / pageSize * pageSize;
+    if ( pageFirst < pageLast )
+        ::madvise( reinterpret_cast<void *>( pageFirst ),
+                   pageLast - pageFirst, MADV_DONTNEED );
+#else
+    (void)first;
+    (void)last;
+#endif
+}
+
+} // namespace conv
@@ -0,0 +1,51 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace conv
+{
+
+/// Read-only view of the whole contents of a file.
+///
+/// On POSIX systems the file is mapped into memory with @c mmap(). Hence
+/// opening even a file of several gigabytes is instantaneous and pages
+/// are only loaded from disk when they are touched. On other systems the
+/// contents of the file are read into memory as a fallback.
+class MappedFile
+{
+public:
+    /// Throws, if the file cannot be opened or mapped.
+    explicit MappedFile( const std::string & fileName );
+    ~MappedFile();
+
+    MappedFile( const MappedFile & ) = delete;
+    MappedFile & operator=( const MappedFile & ) = delete;
+
+    const char * begin() const;
+    const char * end() const;
+    std::size_t size() const;
+    const std::string & fileName() const;
+
+    /// Tells the operating system that the characters in @c [first,last)
+    /// will probably not be accessed again.
+    ///
+    /// The pages which lie completely inside the range are dropped from
+    /// the memory of the process. If they are accessed again nevertheless,
+    /// then they are loaded again from the file. Reading a big file from
+    /// front to back and releasing what has been consumed keeps the
+    /// resident memory small.
+    void release( const char * first, const char * last ) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m;
+};
+
+} // namespace conv
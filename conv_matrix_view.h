@@ -0,0 +1,63 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+
+namespace conv
+{
+
+/// Read-only view of a matrix whose rows (or columns, if the view is
+/// transposed) lie at a fixed distance from each other in memory.
+///
+/// The transposed view of a matrix just refers to the same elements, so
+/// a matrix can be processed as if it was transposed without moving any
+/// data. Whether a view is transposed is part of its type. Hence loops
+/// over the elements are compiled for the respective memory layout and
+/// contain no run-time checks.
+template <typename T, bool isTransposed = false>
+class StridedView
+{
+public:
+    /// For a view which is not transposed @c stride is the distance
+    /// between two rows. Otherwise it is the distance between two columns.
+    StridedView( const T * data, std::size_t nRows, std::size_t nCols,
+                 std::size_t stride )
+        : first( data )
+        , rows( nRows )
+        , cols( nCols )
+        , stride( stride )
+    {
+    }
+
+    /// Whether the elements of a row are adjacent in memory.
+    static const bool hasContiguousRows = !isTransposed;
+
+    std::size_t nRows() const { return rows; }
+    std::size_t nCols() const { return cols; }
+    /// Distance between two consecutive rows in elements.
+    std::size_t rowStride() const { return isTransposed ? 1 : stride; }
+    /// Distance between two consecutive columns in elements.
+    std::size_t colStride() const { return isTransposed ? stride : 1; }
+
+    const T & operator()( std::size_t i, std::size_t j ) const
+    {
+        return isTransposed ? first[j*stride + i] : first[i*stride + j];
+    }
+
+    StridedView<T, !isTransposed> transposed() const
+    {
+        return StridedView<T, !isTransposed>( first, cols, rows, stride );
+    }
+
+private:
+    const T * first;
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t stride;
+};
+
+} // namespace conv
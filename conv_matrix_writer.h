@@ -0,0 +1,32 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_matrix_view.h"
+
+namespace conv
+{
+
+/// Writes a matrix to a file in some format block of rows by block of
+/// rows.
+///
+/// The conversion chooses the implementation for the output format once.
+/// The virtual functions are only called once per block, so the loops
+/// over the elements are still compiled for the format.
+template <typename T>
+class MatrixWriter
+{
+public:
+    virtual ~MatrixWriter() = default;
+
+    /// Appends rows to the file.
+    virtual void append( const StridedView<T> & rows ) = 0;
+
+    /// Completes the file. Throws, if it could not be written.
+    virtual void finish() = 0;
+};
+
+} // namespace conv
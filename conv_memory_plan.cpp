@@ -0,0 +1,181 @@
+#include "conv_memory_plan.h"
+
+#include "conv_mapped_file.h"
+#include "conv_parsing.h"
+
+#include <algorithm>
+
+namespace conv
+{
+
+namespace
+{
+
+// Number of characters at the beginning of a file which are sampled to
+// estimate the size of the matrix.
+const std::size_t sampleSize = 1 << 20;
+
+// Smallest block of characters which is parsed at once by the streaming
+// strategy.
+const std::size_t minBlockSize = 1 << 16;
+
+
+// Returns whether a token which is not an integer needs a wider type.
+// Tokens which are not numbers at all only need one, if they abort the
+// conversion, so that the error is reported by the parser for doubles.
+bool needsWiderType( NonNumber kind, BadLines badLines )
+{
+    return kind == NonNumber::Unfit ||
+            ( kind == NonNumber::Invalid && badLines == BadLines::Abort );
+}
+
+
+// Widens the type, if the number in @c [first,last) does not fit into it.
+void widenToFit( NumberType & numberType,
+                 const char * first, const char * last,
+                 const MissingValueRules & missingValueRules,
+                 BadLines badLines )
+{
+    std::int32_t int32 = 0;
+    std::int64_t int64 = 0;
+    if ( numberType == NumberType::Int32 &&
+         !parseInteger( first, last, int32 ) &&
+         needsWiderType( classifyNonNumber( first, last, missingValueRules,
+                                            int32 ), badLines ) )
+        numberType = NumberType::Int64;
+    if ( numberType == NumberType::Int64 &&
+         !parseInteger( first, last, int64 ) &&
+         needsWiderType( classifyNonNumber( first, last, missingValueRules,
+                                            int64 ), badLines ) )
+        numberType = NumberType::Double;
+}
+
+} // unnamed namespace
+
+
+const char * describe( MemoryStrategy strategy )
+{
+    switch ( strategy )
+    {
+    case MemoryStrategy::InMemory:  return "in memory";
+    case MemoryStrategy::Streaming: return "streaming";
+    case MemoryStrategy::OutOfCore: return "out of core";
+    }
+    return "";
+}
+
+
+FootprintEstimate estimateFootprint(
+        const MappedFile & file, const FileHeader & header,
+        const FixedWidthLayout & layout,
+        const MissingValueRules & missingValueRules, BadLines badLines )
+{
+    FootprintEstimate estimate;
+    estimate.fileSize = file.size();
+    const auto dataBegin = file.begin() + header.size;
+    if ( !layout.isEmpty() )
+    {
+        estimate.nRows = nFixedWidthRows( file, header, layout );
+        estimate.nCols = layout.widths.size();
+        const auto nSampledRows = std::min( estimate.nRows,
+                                            std::max<std::size_t>(
+                    sampleSize / layout.lineLength, 1 ) );
+        for ( std::size_t i = 0; i < nSampledRows; ++i )
+        {
+            const auto line = dataBegin + i * layout.lineLength;
+            for ( std::size_t j = 0; j < estimate.nCols; ++j )
+            {
+                const auto value = fieldValue( line, layout, j );
+                widenToFit( estimate.numberType, value.first, value.second,
+                            missingValueRules, badLines );
+            }
+        }
+        return estimate;
+    }
+
+    const auto sampleLast = dataBegin +
+            std::min<std::size_t>( file.end() - dataBegin, sampleSize );
+    std::size_t nSampledLines = 0;
+    std::size_t nSampledRows = 0;
+    const char * sampledLast = dataBegin;
+    forEachLine( dataBegin, sampleLast,
+                 [&]( const char * first, const char * last )
+    {
+        // A line cut off at the end of the sample is not counted.
+        if ( last == sampleLast && sampleLast != file.end() )
+            return;
+        sampledLast = last;
+        ++nSampledLines;
+        std::size_t nValues = 0;
+        forEachToken( first, last, [&]( const char * tokenFirst,
+                                        const char * tokenLast )
+        {
+            ++nValues;
+            widenToFit( estimate.numberType, tokenFirst, tokenLast,
+                        missingValueRules, badLines );
+        } );
+        if ( nValues == 0 )
+            return;
+        ++nSampledRows;
+        if ( estimate.nCols == 0 )
+            estimate.nCols = nValues;
+    } );
+    if ( nSampledLines == 0 )
+        return estimate;
+
+    // Extrapolate the sample to the whole file.
+    const auto scale = double( file.end() - dataBegin ) /
+            std::max<std::size_t>( sampledLast - dataBegin, 1 );
+    estimate.nRows = std::size_t( nSampledRows * scale );
+    return estimate;
+}
+
+
+MemoryPlan planMemory( const FootprintEstimate & estimate,
+                       std::size_t valueSize, std::size_t memoryBudget,
+                       bool shallTranspose )
+{
+    // The values are parsed directly into the matrix. The text of a block
+    // is resident from the pass which counts its rows until it has been
+    // parsed, so it is counted in addition to the values. For the whole
+    // matrix the block is the whole file.
+    const auto matrixBytes =
+            double( estimate.nRows ) * estimate.nCols * valueSize;
+    MemoryPlan plan;
+    plan.blockSize = estimate.fileSize;
+    plan.bandWidth = estimate.nCols;
+    plan.estimatedBytes = std::size_t( matrixBytes + estimate.fileSize );
+    if ( memoryBudget == 0 || plan.estimatedBytes <= memoryBudget ||
+         estimate.fileSize == 0 )
+        return plan;
+
+    if ( !shallTranspose )
+    {
+        // Each character of a block takes one byte of text and the bytes
+        // of the values parsed from it.
+        plan.strategy = MemoryStrategy::Streaming;
+        const auto bytesPerChar = matrixBytes / estimate.fileSize + 1;
+        plan.blockSize = std::max( minBlockSize,
+                                   std::size_t( memoryBudget / bytesPerChar ) );
+        plan.estimatedBytes = std::size_t( bytesPerChar * plan.blockSize );
+        return plan;
+    }
+
+    // Only the values of a band of columns are kept from each pass over
+    // the whole file. The file is still read in blocks, since the text of
+    // a block stays resident until its rows have been parsed. The budget
+    // is shared equally by the text of a block and the band.
+    plan.strategy = MemoryStrategy::OutOfCore;
+    const auto columnBytes = double( estimate.nRows ) * valueSize;
+    plan.blockSize = std::max( minBlockSize, memoryBudget / 2 );
+    const auto bandBudget = memoryBudget - std::min( memoryBudget,
+                                                     plan.blockSize );
+    plan.bandWidth = std::min( estimate.nCols, std::max<std::size_t>(
+                std::size_t( bandBudget / std::max( columnBytes, 1. ) ),
+                1 ) );
+    plan.estimatedBytes = std::size_t( columnBytes * plan.bandWidth ) +
+            plan.blockSize;
+    return plan;
+}
+
+} // namespace conv
@@ -0,0 +1,86 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_fixed_width.h"
+#include "conv_header.h"
+#include "conv_missing_values.h"
+#include "conv_parse_errors.h"
+#include "conv_parsing.h"
+
+#include <cstddef>
+
+namespace conv
+{
+
+class MappedFile;
+
+/// Ways of converting a matrix which need different amounts of memory.
+enum class MemoryStrategy
+{
+    /// The whole matrix is parsed into memory before it is written.
+    InMemory,
+    /// Blocks of rows are parsed and written one after another. This is
+    /// only possible, if the matrix is not transposed.
+    Streaming,
+    /// The file is read several times. Each pass parses a band of
+    /// columns, transposes it and writes it as the next output rows.
+    OutOfCore,
+};
+
+/// Returns a text like "in memory" for messages.
+const char * describe( MemoryStrategy strategy );
+
+
+/// Size of a matrix file and of its contents estimated from a sample.
+struct FootprintEstimate
+{
+    std::size_t fileSize = 0;
+    /// Number of values in the first row.
+    std::size_t nCols = 0;
+    std::size_t nRows = 0;
+    /// Narrowest type which can hold all values in the sample.
+    NumberType numberType = NumberType::Int32;
+};
+
+/// Estimates the footprint of the matrix in the file from the rows after
+/// the header and detects the type of its values.
+///
+/// If the values are in the fields of a non-empty layout, then the numbers
+/// of rows and columns are exact. Missing values only widen the type, if
+/// their fill value does not fit into it. Tokens which are not numbers do
+/// not widen it either, unless bad lines abort the conversion.
+FootprintEstimate estimateFootprint(
+        const MappedFile & file, const FileHeader & header,
+        const FixedWidthLayout & layout,
+        const MissingValueRules & missingValueRules, BadLines badLines );
+
+
+/// Strategy for converting a matrix within a memory budget.
+struct MemoryPlan
+{
+    MemoryStrategy strategy = MemoryStrategy::InMemory;
+    /// Estimated peak memory consumption of the values and of the text
+    /// of the input which is resident while it is parsed.
+    std::size_t estimatedBytes = 0;
+    /// Number of characters of the input file which are parsed at once.
+    std::size_t blockSize = 0;
+    /// Number of columns which are parsed by each pass of the out-of-core
+    /// strategy.
+    std::size_t bandWidth = 0;
+};
+
+/// Chooses the fastest strategy whose estimated footprint fits into the
+/// memory budget given in bytes, if the values are stored with
+/// @c valueSize bytes each. A budget of zero means no limit.
+///
+/// If even the slowest strategy does not fit, then it is chosen anyway
+/// with the smallest possible blocks.
+MemoryPlan planMemory( const FootprintEstimate & estimate,
+                       std::size_t valueSize, std::size_t memoryBudget,
+                       bool shallTranspose );
+
+} // namespace conv
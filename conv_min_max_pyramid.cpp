@@ -0,0 +1,263 @@
+#include "conv_min_max_pyramid.h"
+
+#include "conv_mapped_file.h"
+#include "conv_parallel.h"
+#include "conv_parsing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+namespace conv
+{
+
+namespace
+{
+
+// Number of bytes of the input file which are processed as one piece.
+const std::size_t pieceSize = 4 << 20;
+// Minimum time between two snapshots passed to the progress callback.
+const auto snapshotInterval = std::chrono::milliseconds( 100 );
+
+// Returns the start of each piece followed by the end of the last piece.
+// Pieces start at the beginning of a line.
+std::vector<const char *> splitIntoPieces( const char * first,
+                                           const char * last )
+{
+    std::vector<const char *> bounds( 1, first );
+    while ( static_cast<std::size_t>( last - bounds.back() ) > pieceSize )
+    {
+        const auto searchStart = bounds.back() + pieceSize;
+        const auto lineBreak = static_cast<const char *>(
+                    std::memchr( searchStart, '\n', last - searchStart ) );
+        if ( !lineBreak )
+            break;
+        bounds.push_back( lineBreak + 1 );
+    }
+    if ( bounds.back() != last )
+        bounds.push_back( last );
+    return bounds;
+}
+
+
+std::size_t countTokensOfFirstNonBlankLine( const char * first,
+                                            const char * last )
+{
+    while ( first != last )
+    {
+        auto lineEnd = static_cast<const char *>(
+                    std::memchr( first, '\n', last - first ) );
+        if ( !lineEnd )
+            lineEnd = last;
+        std::size_t nTokens = 0;
+        forEachToken( first, lineEnd, [&]( const char *, const char * )
+        {
+            ++nTokens;
+        } );
+        if ( nTokens != 0 )
+            return nTokens;
+        first = lineEnd == last ? last : lineEnd + 1;
+    }
+    return 0;
+}
+
+
+// Returns the indices 0,...,n-1 in bit-reversed order. Consecutive
+// entries of the result are thus far apart from each other.
+std::vector<std::size_t> scatteredOrder( std::size_t n )
+{
+    std::size_t nBits = 0;
+    while ( ( std::size_t(1) << nBits ) < n )
+        ++nBits;
+    std::vector<std::size_t> result;
+    result.reserve( n );
+    for ( std::size_t i = 0; i < ( std::size_t(1) << nBits ); ++i )
+    {
+        std::size_t reversed = 0;
+        for ( std::size_t bit = 0; bit < nBits; ++bit )
+            if ( i & ( std::size_t(1) << bit ) )
+                reversed |= std::size_t(1) << ( nBits - 1 - bit );
+        if ( reversed < n )
+            result.push_back( reversed );
+    }
+    return result;
+}
+
+} // unnamed namespace
+
+
+MinMaxGrid::MinMaxGrid( std::size_t width, std::size_t height )
+    : width( width )
+    , height( height )
+    , mins( width*height, std::numeric_limits<float>::infinity() )
+    , maxs( width*height, -std::numeric_limits<float>::infinity() )
+{
+}
+
+
+bool MinMaxGrid::isEmpty( std::size_t x, std::size_t y ) const
+{
+    return mins[y*width+x] > maxs[y*width+x];
+}
+
+
+void MinMaxGrid::add( std::size_t x, std::size_t y, float value )
+{
+    auto & min = mins[y*width+x];
+    auto & max = maxs[y*width+x];
+    min = std::min( min, value );
+    max = std::max( max, value );
+}
+
+
+void MinMaxGrid::merge( const MinMaxGrid & other, std::size_t yOffset )
+{
+    assert( other.width == width );
+    assert( yOffset + other.height <= height );
+    const auto offset = yOffset*width;
+    for ( std::size_t i = 0; i < other.mins.size(); ++i )
+    {
+        mins[offset+i] = std::min( mins[offset+i], other.mins[i] );
+        maxs[offset+i] = std::max( maxs[offset+i], other.maxs[i] );
+    }
+}
+
+
+MinMaxPyramid::MinMaxPyramid( MinMaxGrid base )
+{
+    levels.push_back( std::move(base) );
+    while ( levels.back().width > 1 || levels.back().height > 1 )
+    {
+        const auto & fine = levels.back();
+        MinMaxGrid coarse( (fine.width+1)/2, (fine.height+1)/2 );
+        parallelFor( 0, coarse.height, [&]( std::size_t y )
+        {
+            const auto yLast = std::min( 2*y+2, fine.height );
+            for ( std::size_t x = 0; x < coarse.width; ++x )
+            {
+                const auto xLast = std::min( 2*x+2, fine.width );
+                for ( auto fy = 2*y; fy < yLast; ++fy )
+                {
+                    for ( auto fx = 2*x; fx < xLast; ++fx )
+                    {
+                        const auto i = fy*fine.width+fx;
+                        auto & min = coarse.mins[y*coarse.width+x];
+                        auto & max = coarse.maxs[y*coarse.width+x];
+                        min = std::min( min, fine.mins[i] );
+                        max = std::max( max, fine.maxs[i] );
+                    }
+                }
+            }
+        } );
+        levels.push_back( std::move(coarse) );
+    }
+}
+
+
+std::size_t MinMaxPyramid::nLevels() const
+{
+    return levels.size();
+}
+
+
+const MinMaxGrid & MinMaxPyramid::level( std::size_t i ) const
+{
+    return levels.at(i);
+}
+
+
+MinMaxGrid computeMinMaxGrid( const MappedFile & file,
+                              std::size_t maxWidth,
+                              std::size_t maxHeight,
+                              const MinMaxGridProgress & onProgress )
+{
+    const auto bounds = splitIntoPieces( file.begin(), file.end() );
+    const auto nPieces = bounds.size() - 1;
+
+    // Find out which rows belong to which piece.
+    std::vector<std::size_t> firstRows( nPieces + 1, 0 );
+    parallelFor( 0, nPieces, [&]( std::size_t i )
+    {
+        std::size_t nRows = 0;
+        forEachLine( bounds[i], bounds[i+1],
+                     [&]( const char * first, const char * last )
+        {
+            if ( !isBlank( first, last ) )
+                ++nRows;
+        } );
+        firstRows[i+1] = nRows;
+    } );
+    std::partial_sum( begin(firstRows), end(firstRows), begin(firstRows) );
+    const auto nRows = firstRows.back();
+    const auto nCols =
+            countTokensOfFirstNonBlankLine( file.begin(), file.end() );
+
+    MinMaxGrid grid( std::min( nCols, maxWidth ),
+                     std::min( nRows, maxHeight ) );
+    if ( grid.width == 0 || grid.height == 0 )
+    {
+        onProgress( grid, 1. );
+        return grid;
+    }
+
+    // Accumulate the values of each piece in a grid of its own and merge
+    // it into the result afterwards.
+    const auto order = scatteredOrder( nPieces );
+    std::mutex mutex;
+    std::size_t nPiecesDone = 0;
+    bool isCancelled = false;
+    auto lastSnapshotTime = std::chrono::steady_clock::now();
+    parallelFor( 0, nPieces, [&]( std::size_t k )
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if ( isCancelled )
+                return;
+        }
+        const auto i = order[k];
+        if ( firstRows[i] == firstRows[i+1] )
+            return;
+        const auto yFirst = firstRows[i] * grid.height / nRows;
+        const auto yLast = (firstRows[i+1]-1) * grid.height / nRows + 1;
+        MinMaxGrid pieceGrid( grid.width, yLast - yFirst );
+        auto row = firstRows[i];
+        forEachLine( bounds[i], bounds[i+1],
+                     [&]( const char * first, const char * last )
+        {
+            if ( isBlank( first, last ) )
+                return;
+            const auto y = row * grid.height / nRows - yFirst;
+            std::size_t col = 0;
+            forEachToken( first, last,
+                          [&]( const char * tokenFirst, const char * tokenLast )
+            {
+                double value = 0;
+                if ( col < nCols &&
+                     parseDouble( tokenFirst, tokenLast, value ) )
+                    pieceGrid.add( col * grid.width / nCols, y,
+                                   static_cast<float>( value ) );
+                ++col;
+            } );
+            ++row;
+        } );
+
+        std::lock_guard<std::mutex> lock( mutex );
+        grid.merge( pieceGrid, yFirst );
+        ++nPiecesDone;
+        const auto now = std::chrono::steady_clock::now();
+        if ( !isCancelled && nPiecesDone != nPieces &&
+             now - lastSnapshotTime >= snapshotInterval )
+        {
+            lastSnapshotTime = now;
+            isCancelled = !onProgress( grid, double(nPiecesDone) / nPieces );
+        }
+    } );
+    if ( !isCancelled )
+        onProgress( grid, 1. );
+    return grid;
+}
+
+} // namespace conv
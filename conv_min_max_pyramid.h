@@ -0,0 +1,80 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace conv
+{
+
+class MappedFile;
+
+/// Minimum and maximum values of the rectangular blocks of a matrix.
+///
+/// The block of a cell which has not seen any values yet has the minimum
+/// @c +infinity and the maximum @c -infinity.
+struct MinMaxGrid
+{
+    MinMaxGrid() = default;
+    MinMaxGrid( std::size_t width, std::size_t height );
+
+    bool isEmpty( std::size_t x, std::size_t y ) const;
+    void add( std::size_t x, std::size_t y, float value );
+    /// Merges the cells of @c other into the cells of this grid starting
+    /// at row @c yOffset. The grids must have the same width.
+    void merge( const MinMaxGrid & other, std::size_t yOffset );
+
+    std::size_t width = 0;
+    std::size_t height = 0;
+    // row-major
+    std::vector<float> mins;
+    std::vector<float> maxs;
+};
+
+
+/// Mip-map like levels of min/max grids.
+///
+/// Level 0 is the grid the pyramid has been constructed from. Each
+/// further level halves the width and height of the previous one until
+/// a single cell remains. Zooming in a view can thus pick a suitable
+/// resolution without touching the matrix again.
+class MinMaxPyramid
+{
+public:
+    /// Computes the coarser levels in parallel.
+    explicit MinMaxPyramid( MinMaxGrid base );
+
+    std::size_t nLevels() const;
+    const MinMaxGrid & level( std::size_t i ) const;
+
+private:
+    std::vector<MinMaxGrid> levels;
+};
+
+
+/// Called with intermediate results while a min/max grid is computed.
+///
+/// The second parameter is the fraction of the work done so far.
+/// Returning @c false cancels the computation.
+using MinMaxGridProgress = std::function<bool( const MinMaxGrid &, double )>;
+
+/// Computes the min/max grid of the matrix contained in a text file.
+///
+/// Rows are the non-empty lines of the file and each cell covers a block
+/// of about equal size. The grid is at most @c maxWidth by @c maxHeight
+/// cells. The file is processed in parallel in pieces in a scattered
+/// order, so that the snapshots passed to @c onProgress refine
+/// the whole picture progressively. Tokens which are not numbers are
+/// ignored. If the computation is cancelled, then the partial result is
+/// returned.
+MinMaxGrid computeMinMaxGrid( const MappedFile & file,
+                              std::size_t maxWidth,
+                              std::size_t maxHeight,
+                              const MinMaxGridProgress & onProgress );
+
+} // namespace conv
@@ -0,0 +1,151 @@
+#include "conv_missing_values.h"
+
+#include "conv_parsing.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+namespace conv
+{
+
+namespace
+{
+
+// Number of bytes of the bitmap which are written at once.
+const std::size_t bitmapBufferSize = 1 << 20;
+
+// Returns whether the fill value can be stored as a @c T without change.
+bool fits( double, double )
+{
+    return true;
+}
+
+
+template <typename T>
+bool fits( double fillValue, T )
+{
+    // The bounds are powers of two, which are exact as doubles. NaN is
+    // rejected by the comparisons.
+    const auto min = double( std::numeric_limits<T>::min() );
+    return fillValue >= min && fillValue < -min &&
+            std::trunc( fillValue ) == fillValue;
+}
+
+
+template <typename T>
+bool fill( const MissingValueRules & rules, T & value )
+{
+    if ( !fits( rules.fillValue, T() ) )
+        return false;
+    value = static_cast<T>( rules.fillValue );
+    return true;
+}
+
+
+template <typename T>
+NonNumber classify( const char * first, const char * last,
+                    const MissingValueRules & rules, T & value )
+{
+    if ( rules.isEnabled && isMissingValue( first, last ) )
+        return fill( rules, value ) ? NonNumber::Missing : NonNumber::Unfit;
+    double number = 0;
+    return !std::is_same<T, double>::value &&
+            parseDouble( first, last, number )
+            ? NonNumber::Unfit
+            : NonNumber::Invalid;
+}
+
+} // unnamed namespace
+
+
+bool fillMissingValue( const MissingValueRules & rules, double & value )
+{
+    return fill( rules, value );
+}
+
+
+bool fillMissingValue( const MissingValueRules & rules,
+                       std::int32_t & value )
+{
+    return fill( rules, value );
+}
+
+
+bool fillMissingValue( const MissingValueRules & rules,
+                       std::int64_t & value )
+{
+    return fill( rules, value );
+}
+
+
+NonNumber classifyNonNumber( const char * first, const char * last,
+                             const MissingValueRules & rules,
+                             double & value )
+{
+    return classify( first, last, rules, value );
+}
+
+
+NonNumber classifyNonNumber( const char * first, const char * last,
+                             const MissingValueRules & rules,
+                             std::int32_t & value )
+{
+    return classify( first, last, rules, value );
+}
+
+
+NonNumber classifyNonNumber( const char * first, const char * last,
+                             const MissingValueRules & rules,
+                             std::int64_t & value )
+{
+    return classify( first, last, rules, value );
+}
+
+
+void writeMissingValueBitmap( const std::string & fileName,
+                              std::vector<MissingValue> missingValues,
+                              std::size_t nRows, std::size_t nCols,
+                              bool shallTranspose )
+{
+    if ( shallTranspose )
+    {
+        for ( auto & missingValue : missingValues )
+            std::swap( missingValue.row, missingValue.col );
+        std::swap( nRows, nCols );
+    }
+    std::sort( begin(missingValues), end(missingValues),
+               []( const MissingValue & lhs, const MissingValue & rhs )
+    {
+        return lhs.row != rhs.row ? lhs.row < rhs.row : lhs.col < rhs.col;
+    } );
+
+    std::ofstream file( fileName, std::ios::binary );
+    const auto rowSize = ( nCols + 7 ) / 8;
+    std::vector<char> buffer;
+    auto missingValue = begin(missingValues);
+    for ( std::size_t i = 0; i < nRows; ++i )
+    {
+        const auto row = buffer.size();
+        buffer.resize( row + rowSize );
+        for ( ; missingValue != end(missingValues) &&
+                missingValue->row == i; ++missingValue )
+            buffer[row + missingValue->col / 8] |=
+                    char( 1 << missingValue->col % 8 );
+        if ( buffer.size() >= bitmapBufferSize || i + 1 == nRows )
+        {
+            file.write( buffer.data(), buffer.size() );
+            buffer.clear();
+        }
+    }
+    file.flush();
+    if ( !file.good() )
+        CU_THROW( "Failed to write the bitmap of missing values '" +
+                  fileName + "'." );
+}
+
+} // namespace conv
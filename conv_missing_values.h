@@ -0,0 +1,106 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// What happens to rows which contain a different number of values than
+/// the others.
+enum class RaggedRows
+{
+    /// They are errors.
+    Error,
+    /// Shorter rows are filled up with the fill value to the length of the
+    /// longest row.
+    Pad,
+    /// Longer rows are cut off at the length of the shortest row.
+    Truncate,
+    /// Like Pad, but the filled in values count as missing values, so the
+    /// bitmap of missing values tells which values the rows contain.
+    Sparse,
+};
+
+
+/// How values are treated which are not in the file. See isMissingValue()
+/// for the tokens which mark missing values.
+struct MissingValueRules
+{
+    /// Whether tokens which mark missing values are accepted. Otherwise
+    /// they are errors.
+    bool isEnabled = false;
+    /// Value which is stored instead of a missing value. Integers can only
+    /// be filled with integers. NaN by default.
+    double fillValue = std::numeric_limits<double>::quiet_NaN();
+    /// Whether rows may have different lengths.
+    RaggedRows raggedRows = RaggedRows::Error;
+};
+
+
+/// Position of a missing value in a matrix.
+struct MissingValue
+{
+    std::size_t row;
+    std::size_t col;
+};
+
+
+/// Stores the fill value in @c value. Returns @c false, if it does not fit.
+bool fillMissingValue( const MissingValueRules & rules, double & value );
+bool fillMissingValue( const MissingValueRules & rules,
+                       std::int32_t & value );
+bool fillMissingValue( const MissingValueRules & rules,
+                       std::int64_t & value );
+
+/// What a token is which is not a number of the type of the values.
+enum class NonNumber
+{
+    /// A missing value. The fill value has been stored.
+    Missing,
+    /// A number or a missing value whose fill value does not fit into the
+    /// type of the values.
+    Unfit,
+    /// Neither a number nor a missing value.
+    Invalid,
+};
+
+/// Tells what the token @c [first,last) is, after parseNumber() has
+/// rejected it. If it is a missing value and the fill value fits into
+/// @c value, then the fill value is stored in @c value.
+///
+/// Parsers only call this for the rare tokens which are not numbers, so
+/// the parsing of numbers is not slowed down by missing values.
+NonNumber classifyNonNumber( const char * first, const char * last,
+                             const MissingValueRules & rules,
+                             double & value );
+NonNumber classifyNonNumber( const char * first, const char * last,
+                             const MissingValueRules & rules,
+                             std::int32_t & value );
+NonNumber classifyNonNumber( const char * first, const char * last,
+                             const MissingValueRules & rules,
+                             std::int64_t & value );
+
+/// Writes a bitmap which tells for each value of the matrix whether it is
+/// missing.
+///
+/// The bitmap has a row of @c (nCols+7)/8 bytes for each row of the
+/// matrix. Bit @c j%8 of byte @c j/8 of a row is set, if the value in
+/// column @c j is missing. If @c shallTranspose is @c true, then the
+/// bitmap is written for the transposed matrix. Since missing values are
+/// rare, only their positions are held in memory and the bitmap is
+/// written row by row.
+void writeMissingValueBitmap( const std::string & fileName,
+                              std::vector<MissingValue> missingValues,
+                              std::size_t nRows, std::size_t nCols,
+                              bool shallTranspose );
+
+} // namespace conv
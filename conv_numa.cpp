@@ -0,0 +1,141 @@
+#include "conv_numa.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef CONVERT_MATRIX_USE_LIBNUMA
+#include <numa.h>
+#endif
+
+namespace conv
+{
+
+namespace
+{
+
+// Returns the CPUs the process is allowed to run on.
+std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    if ( sched_getaffinity( 0, sizeof(set), &set ) == 0 )
+    {
+        for ( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+            if ( CPU_ISSET( cpu, &set ) )
+                cpus.push_back( cpu );
+        return cpus;
+    }
+#endif
+    const auto n = std::max( std::thread::hardware_concurrency(), 1u );
+    for ( unsigned cpu = 0; cpu < n; ++cpu )
+        cpus.push_back( static_cast<int>( cpu ) );
+    return cpus;
+}
+
+
+#if defined(__linux__) && !defined(CONVERT_MATRIX_USE_LIBNUMA)
+// Parses a cpu list of the form "0-7,16-23".
+std::vector<int> parseCpuList( const std::string & list )
+{
+    std::vector<int> cpus;
+    std::istringstream is( list );
+    std::string range;
+    while ( std::getline( is, range, ',' ) )
+    {
+        int first = 0;
+        int last = 0;
+        char dash = 0;
+        std::istringstream rangeStream( range );
+        if ( !( rangeStream >> first ) )
+            continue;
+        last = first;
+        if ( rangeStream >> dash >> last && dash != '-' )
+            continue;
+        for ( auto cpu = first; cpu <= last; ++cpu )
+            cpus.push_back( cpu );
+    }
+    return cpus;
+}
+#endif
+
+
+// Returns the CPUs of each node irrespective of the affinity mask.
+std::vector<std::vector<int>> cpusOfAllNodes()
+{
+    std::vector<std::vector<int>> result;
+#if defined(CONVERT_MATRIX_USE_LIBNUMA)
+    if ( numa_available() < 0 )
+        return result;
+    const auto mask = numa_allocate_cpumask();
+    for ( int node = 0; node <= numa_max_node(); ++node )
+    {
+        result.emplace_back();
+        if ( numa_node_to_cpus( node, mask ) != 0 )
+            continue;
+        for ( unsigned cpu = 0; cpu < mask->size; ++cpu )
+            if ( numa_bitmask_isbitset( mask, cpu ) )
+                result.back().push_back( static_cast<int>( cpu ) );
+    }
+    numa_free_cpumask( mask );
+#elif defined(__linux__)
+    for ( int node = 0; ; ++node )
+    {
+        std::ifstream file( "/sys/devices/system/node/node" +
+                            std::to_string(node) + "/cpulist" );
+        if ( !file )
+            break;
+        std::string list;
+        std::getline( file, list );
+        result.push_back( parseCpuList( list ) );
+    }
+#endif
+    return result;
+}
+
+} // unnamed namespace
+
+
+NumaTopology detectNumaTopology()
+{
+    const auto allowed = allowedCpus();
+    NumaTopology topology;
+    for ( const auto & cpus : cpusOfAllNodes() )
+    {
+        std::vector<int> cpusOfNode;
+        for ( const auto cpu : cpus )
+            if ( std::find( begin(allowed), end(allowed), cpu ) !=
+                 end(allowed) )
+                cpusOfNode.push_back( cpu );
+        if ( !cpusOfNode.empty() )
+            topology.cpusOfNodes.push_back( std::move(cpusOfNode) );
+    }
+    if ( topology.cpusOfNodes.empty() )
+        topology.cpusOfNodes.push_back( allowed );
+    return topology;
+}
+
+
+bool pinCurrentThread( const std::vector<int> & cpus )
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    for ( const auto cpu : cpus )
+        if ( cpu >= 0 && cpu < CPU_SETSIZE )
+            CPU_SET( cpu, &set );
+    return pthread_setaffinity_np( pthread_self(), sizeof(set), &set ) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+} // namespace conv
@@ -0,0 +1,32 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <vector>
+
+namespace conv
+{
+
+/// The CPUs the process may run on grouped by NUMA node.
+struct NumaTopology
+{
+    /// Nodes without allowed CPUs are left out.
+    std::vector<std::vector<int>> cpusOfNodes;
+};
+
+/// Determines the NUMA topology of the machine.
+///
+/// If the program is built with @c CONVERT_MATRIX_USE_LIBNUMA, then
+/// libnuma is asked. Otherwise the topology is read from sysfs on Linux.
+/// If neither works, then all CPUs are considered to belong to one node.
+NumaTopology detectNumaTopology();
+
+/// Restricts the calling thread to run on the given CPUs.
+///
+/// Returns @c false, if this is not supported on the platform or fails.
+bool pinCurrentThread( const std::vector<int> & cpus );
+
+} // namespace conv
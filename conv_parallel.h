@@ -0,0 +1,100 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace conv
+{
+
+namespace detail
+{
+
+// Calls f(i) for each i in [first,last). Halves of the range are handed
+// to the thread pool as long as they are bigger than grainSize, so that
+// idle workers steal big pieces of work.
+template <typename F>
+void forEachIndex( TaskGroup & group, std::size_t first, std::size_t last,
+                   std::size_t grainSize, F & f )
+{
+    while ( last - first > grainSize )
+    {
+        const auto middle = first + ( last - first ) / 2;
+        group.run( [&group, middle, last, grainSize, &f]
+        {
+            forEachIndex( group, middle, last, grainSize, f );
+        } );
+        last = middle;
+    }
+    for ( ; first != last; ++first )
+        f( first );
+}
+
+} // namespace detail
+
+
+/// Calls @c f(i) for each @c i in @c [first,last) in parallel using the
+/// shared thread pool.
+///
+/// The range is split recursively and the workers steal pieces from each
+/// other. Thus the load is balanced well, even if the calls take very
+/// different amounts of time. The calling thread helps processing the
+/// range. If calls throw, the first exception is rethrown after all
+/// calls have finished.
+template <typename F>
+void parallelFor( std::size_t first, std::size_t last, F && f )
+{
+    if ( first >= last )
+        return;
+    // A few pieces per worker are enough for balancing the load.
+    const auto grainSize = std::max<std::size_t>(
+                ( last - first ) / ( 8 * ThreadPool::instance().nThreads() ),
+                1 );
+    TaskGroup group;
+    detail::forEachIndex( group, first, last, grainSize, f );
+    group.wait();
+}
+
+
+/// Like parallelFor(), but the range is divided into one contiguous block
+/// per NUMA node and each block is only processed by the workers of its
+/// node.
+///
+/// If the indices refer to consecutive parts of a buffer, then the pages
+/// touched first by this function are placed on the node which processes
+/// them, and later calls with the same range work on node-local memory.
+template <typename F>
+void parallelForOnNodes( std::size_t first, std::size_t last, F && f )
+{
+    auto & pool = ThreadPool::instance();
+    const auto nNodes = pool.nNodes();
+    if ( nNodes == 1 )
+        return parallelFor( first, last, f );
+    const auto n = last - first;
+    const auto grainSize = std::max<std::size_t>(
+                n / ( 8 * pool.nThreads() ), 1 );
+    TaskGroup group;
+    for ( std::size_t node = 0; node < nNodes; ++node )
+    {
+        const auto blockLast = first + n * (node+1) / nNodes;
+        for ( auto i = first + n * node / nNodes; i < blockLast;
+              i += grainSize )
+        {
+            const auto pieceLast = std::min( i + grainSize, blockLast );
+            group.runOnNode( node, [i, pieceLast, &f]
+            {
+                for ( auto k = i; k != pieceLast; ++k )
+                    f( k );
+            } );
+        }
+    }
+    group.wait();
+}
+
+} // namespace conv
@@ -0,0 +1,41 @@
+#include "conv_parse_errors.h"
+
+#include "cpp_utils/exception.h"
+
+#include <fstream>
+
+namespace conv
+{
+
+std::string describe( const ParseError & error, std::size_t nCols )
+{
+    switch ( error.kind )
+    {
+    case ParseErrorKind::NotANumber:
+        if ( error.nValues == nCols )
+            return "not a number";
+        return "not a number, " + std::to_string( error.nValues ) +
+                " values instead of " + std::to_string( nCols );
+    case ParseErrorKind::WrongLength:
+        return std::to_string( error.nValues ) + " values instead of " +
+                std::to_string( nCols );
+    }
+    return "";
+}
+
+
+void writeErrorReport( const std::string & fileName,
+                       const std::vector<ParseError> & errors,
+                       std::size_t nCols )
+{
+    std::ofstream file( fileName );
+    file << "line\tcolumn\toffset\treason\n";
+    for ( const auto & error : errors )
+        file << error.line << '\t' << error.column << '\t' << error.offset
+             << '\t' << describe( error, nCols ) << '\n';
+    file.flush();
+    if ( !file.good() )
+        CU_THROW( "Failed to write the error report '" + fileName + "'." );
+}
+
+} // namespace conv
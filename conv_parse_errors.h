@@ -0,0 +1,68 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// What happens to lines of the input file which cannot be parsed.
+enum class BadLines
+{
+    /// The conversion is aborted with an exception.
+    Abort,
+    /// The lines are left out of the matrix and reported.
+    Drop,
+    /// The faulty values are replaced by the fill value for missing values
+    /// and reported. Rows of the wrong length are padded or truncated.
+    Fill,
+};
+
+
+/// Why a line could not be parsed.
+enum class ParseErrorKind
+{
+    /// A field is not a number.
+    NotANumber,
+    /// The line contains a different number of values than the rows.
+    WrongLength,
+};
+
+
+/// A line of the input file which could not be parsed.
+struct ParseError
+{
+    ParseErrorKind kind;
+    /// One-based number of the line in the file.
+    std::size_t line;
+    /// One-based number of the faulty field or zero, if the whole line is
+    /// faulty.
+    std::size_t column;
+    /// Position of the faulty field or line in the file.
+    std::size_t offset;
+    /// Number of values in the line, if it has the wrong length, or else
+    /// the number of columns of the matrix.
+    std::size_t nValues;
+};
+
+/// Returns a text like "not a number" for the error. A field which is
+/// not a number in a line of the wrong length is described as
+/// "not a number, 5 values instead of 4".
+std::string describe( const ParseError & error, std::size_t nCols );
+
+/// Writes a line for each error with its line, column, byte offset and
+/// reason separated by tabs, preceded by a line with the titles.
+/// There is a single line for each faulty line of the input. It gives
+/// the first field which is not a number and the wrong length of the
+/// line, if both are found.
+void writeErrorReport( const std::string & fileName,
+                       const std::vector<ParseError> & errors,
+                       std::size_t nCols );
+
+} // namespace conv
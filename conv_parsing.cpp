@@ -0,0 +1,454 @@
+#include "conv_parsing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+
+namespace conv
+{
+
+namespace
+{
+
+// Parses the token with the classic locale. This is slow, but handles
+// all the cases which are not covered by the fast path.
+bool parseDoubleSlowly( const char * first, const char * last,
+                        double & value )
+{
+    std::istringstream is( std::string( first, last ) );
+    is.imbue( std::locale::classic() );
+    is >> value;
+    return !is.fail() && is.peek() == std::char_traits<char>::eof();
+}
+
+
+// Kinds of tokens which are no numbers in decimal or hexadecimal notation,
+// but still have a meaning.
+enum class SpecialToken
+{
+    None,
+    NotANumber,
+    Infinity,
+    Missing,
+};
+
+
+struct SpecialTokenEntry
+{
+    const char * text;
+    std::size_t size;
+    SpecialToken kind;
+};
+
+
+// The known tokens in lower case and without sign, each at the position
+// of its hash, see specialTokenHash().
+const SpecialTokenEntry specialTokens[8] = {
+    { "null",     4, SpecialToken::Missing },
+    { "",         0, SpecialToken::None },
+    { "na",       2, SpecialToken::Missing },
+    { "n/a",      3, SpecialToken::Missing },
+    { "",         0, SpecialToken::None },
+    { "inf",      3, SpecialToken::Infinity },
+    { "infinity", 8, SpecialToken::Infinity },
+    { "nan",      3, SpecialToken::NotANumber },
+};
+
+
+// Perfect hash of the known tokens from their lengths and their first and
+// last characters in lower case. The token must not be empty.
+std::size_t specialTokenHash( const char * first, std::size_t size )
+{
+    return ( size + 2 * std::size_t( first[0] | 0x20 ) +
+             4 * std::size_t( first[size-1] | 0x20 ) ) & 7;
+}
+
+
+// Returns what the token @c [first,last) without sign is.
+SpecialToken lookUpSpecialToken( const char * first, const char * last )
+{
+    const auto size = std::size_t( last - first );
+    if ( size == 0 )
+        return SpecialToken::None;
+    const auto & entry = specialTokens[specialTokenHash( first, size )];
+    if ( entry.size != size )
+        return SpecialToken::None;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const auto isLetter = unsigned( entry.text[i] - 'a' ) < 26;
+        if ( ( isLetter ? first[i] | 0x20 : first[i] ) != entry.text[i] )
+            return SpecialToken::None;
+    }
+    return entry.kind;
+}
+
+
+// Parses "nan" and "inf" or "infinity" with an optional sign.
+bool parseSpecialValue( const char * first, const char * last,
+                        double & value )
+{
+    const bool negative = first != last && *first == '-';
+    if ( first != last && ( *first == '-' || *first == '+' ) )
+        ++first;
+    switch ( lookUpSpecialToken( first, last ) )
+    {
+    case SpecialToken::NotANumber:
+        value = std::numeric_limits<double>::quiet_NaN();
+        break;
+    case SpecialToken::Infinity:
+        value = std::numeric_limits<double>::infinity();
+        break;
+    default:
+        return false;
+    }
+    if ( negative )
+        value = -value;
+    return true;
+}
+
+
+// Converts the eight characters at @c p to their value, if they are all
+// decimal digits. The first character is the most significant digit.
+bool parseEightDigits( const char * p, std::uint64_t & value )
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || \
+    defined(_M_X64) || defined(_M_IX86)
+    std::uint64_t chunk;
+    std::memcpy( &chunk, p, sizeof(chunk) );
+    // Each byte must be in the range from '0' to '9'.
+    if ( ( ( chunk & 0xF0F0F0F0F0F0F0F0 ) |
+           ( ( ( chunk + 0x0606060606060606 ) & 0xF0F0F0F0F0F0F0F0 ) >> 4 ) )
+         != 0x3333333333333333 )
+        return false;
+    // Combine adjacent digits to pairs, the pairs to quadruples and
+    // those to the result.
+    chunk -= 0x3030303030303030;
+    chunk = chunk * 10 + ( chunk >> 8 );
+    value = ( ( chunk & 0x000000FF000000FF ) * ( 100 + ( 1000000ULL << 32 ) ) +
+              ( ( chunk >> 16 ) & 0x000000FF000000FF ) *
+              ( 1 + ( 10000ULL << 32 ) ) ) >> 32;
+    return true;
+#else
+    std::uint64_t result = 0;
+    for ( int i = 0; i < 8; ++i )
+    {
+        if ( unsigned(p[i] - '0') >= 10 )
+            return false;
+        result = 10*result + (p[i] - '0');
+    }
+    value = result;
+    return true;
+#endif
+}
+
+
+// Returns the value of the hexadecimal digit @c c or -1, if it is none.
+int hexDigitValue( char c )
+{
+    if ( unsigned(c - '0') < 10 )
+        return c - '0';
+    const auto lower = char( c | 0x20 );
+    if ( unsigned(lower - 'a') < 6 )
+        return lower - 'a' + 10;
+    return -1;
+}
+
+
+// Returns the double nearest to mantissa * 2^exponent. @c isInexact tells
+// whether non-zero bits below the mantissa have been dropped, which
+// decides ties. Ties are rounded to even.
+double composeDouble( bool negative, std::uint64_t mantissa,
+                      std::int64_t exponent, bool isInexact )
+{
+    const std::uint64_t fractionMask = ( std::uint64_t(1) << 52 ) - 1;
+    const std::uint64_t infinityBits = std::uint64_t(0x7FF) << 52;
+    std::uint64_t bits = 0;
+    if ( mantissa != 0 )
+    {
+        // Shift the highest set bit to the top, so the value is in the
+        // range from 2^binaryExponent to 2^(binaryExponent+1).
+        while ( mantissa >> 60 == 0 )
+        {
+            mantissa <<= 4;
+            exponent -= 4;
+        }
+        while ( mantissa >> 63 == 0 )
+        {
+            mantissa <<= 1;
+            exponent -= 1;
+        }
+        const auto binaryExponent = exponent + 63;
+        // Number of low bits of the mantissa which do not fit into the
+        // 53 bits of a normal or the fewer bits of a subnormal double.
+        const auto nDropped = binaryExponent >= -1022
+                ? 11 : 11 + ( -1022 - binaryExponent );
+        if ( binaryExponent > 1023 )
+            bits = infinityBits;
+        else if ( nDropped <= 64 )
+        {
+            auto kept = nDropped < 64 ? mantissa >> nDropped : 0;
+            const auto rest = nDropped < 64
+                    ? mantissa & ( ( std::uint64_t(1) << nDropped ) - 1 )
+                    : mantissa;
+            const auto half = std::uint64_t(1) << ( nDropped - 1 );
+            if ( rest > half || ( rest == half && ( isInexact || kept & 1 ) ) )
+                ++kept;
+            if ( binaryExponent >= -1022 )
+            {
+                auto biasedExponent = std::uint64_t( binaryExponent + 1023 );
+                if ( kept >> 53 )
+                {
+                    kept >>= 1;
+                    ++biasedExponent;
+                }
+                bits = biasedExponent >= 0x7FF
+                        ? infinityBits
+                        : biasedExponent << 52 | ( kept & fractionMask );
+            }
+            else
+                // A carry into bit 52 yields the smallest normal number.
+                bits = kept;
+        }
+    }
+    if ( negative )
+        bits |= std::uint64_t(1) << 63;
+    double value;
+    std::memcpy( &value, &bits, sizeof(value) );
+    return value;
+}
+
+} // unnamed namespace
+
+
+const char * describe( NumberType numberType )
+{
+    switch ( numberType )
+    {
+    case NumberType::Detect: return "detected numbers";
+    case NumberType::Double: return "floating point numbers";
+    case NumberType::Int32:  return "32 bit integers";
+    case NumberType::Int64:  return "64 bit integers";
+    }
+    return "";
+}
+
+
+const char * describeValue( double )
+{
+    return "a floating point number";
+}
+
+
+const char * describeValue( std::int32_t )
+{
+    return "a 32 bit integer";
+}
+
+
+const char * describeValue( std::int64_t )
+{
+    return "a 64 bit integer";
+}
+
+
+bool parseDouble( const char * first, const char * last, double & value )
+{
+    // Fast path: If the decimal mantissa has at most 15 digits and the
+    // decimal exponent is small, then both are exactly representable as
+    // doubles and a single multiplication or division yields the
+    // correctly rounded result.
+    static const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+        1e22 };
+    auto p = first;
+    const bool negative = p != last && *p == '-';
+    if ( p != last && ( *p == '-' || *p == '+' ) )
+        ++p;
+    if ( last - p >= 2 && p[0] == '0' && ( p[1] | 0x20 ) == 'x' )
+        return parseHexFloat( first, last, value );
+    std::uint64_t mantissa = 0;
+    int nDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for ( ; p != last && unsigned(*p - '0') < 10; ++p )
+    {
+        hasDigits = true;
+        if ( mantissa == 0 && *p == '0' )
+            continue;
+        mantissa = 10*mantissa + (*p - '0');
+        ++nDigits;
+    }
+    if ( p != last && *p == '.' )
+    {
+        for ( ++p; p != last && unsigned(*p - '0') < 10; ++p )
+        {
+            hasDigits = true;
+            if ( mantissa == 0 && *p == '0' )
+            {
+                --exponent;
+                continue;
+            }
+            mantissa = 10*mantissa + (*p - '0');
+            ++nDigits;
+            --exponent;
+        }
+    }
+    if ( !hasDigits )
+        return parseSpecialValue( first, last, value );
+    if ( p != last && ( *p == 'e' || *p == 'E' ) )
+    {
+        ++p;
+        const bool negativeExponent = p != last && *p == '-';
+        if ( p != last && ( *p == '-' || *p == '+' ) )
+            ++p;
+        if ( p == last )
+            return false;
+        int e = 0;
+        for ( ; p != last && unsigned(*p - '0') < 10; ++p )
+        {
+            if ( e > 100000 )
+                return parseDoubleSlowly( first, last, value );
+            e = 10*e + (*p - '0');
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if ( p != last )
+        return false;
+    if ( nDigits > 15 || exponent < -22 || exponent > 22 )
+        return parseDoubleSlowly( first, last, value );
+    value = double( mantissa );
+    if ( exponent < 0 )
+        value /= powersOf10[-exponent];
+    else
+        value *= powersOf10[exponent];
+    if ( negative )
+        value = -value;
+    return true;
+}
+
+
+bool isMissingValue( const char * first, const char * last )
+{
+    return first == last ||
+            lookUpSpecialToken( first, last ) == SpecialToken::Missing;
+}
+
+
+bool parseHexFloat( const char * first, const char * last, double & value )
+{
+    auto p = first;
+    const bool negative = p != last && *p == '-';
+    if ( p != last && ( *p == '-' || *p == '+' ) )
+        ++p;
+    if ( last - p < 2 || p[0] != '0' || ( p[1] | 0x20 ) != 'x' )
+        return false;
+    p += 2;
+    // The value is mantissa * 2^exponent. Digits which do not fit into
+    // the mantissa are only needed to decide ties when rounding.
+    std::uint64_t mantissa = 0;
+    std::int64_t exponent = 0;
+    bool isInexact = false;
+    bool hasDigits = false;
+    bool isFraction = false;
+    for ( ; p != last; ++p )
+    {
+        if ( *p == '.' && !isFraction )
+        {
+            isFraction = true;
+            continue;
+        }
+        const auto digit = hexDigitValue( *p );
+        if ( digit < 0 )
+            break;
+        hasDigits = true;
+        if ( mantissa >> 60 == 0 )
+        {
+            mantissa = 16*mantissa + unsigned(digit);
+            if ( isFraction )
+                exponent -= 4;
+        }
+        else
+        {
+            isInexact |= digit != 0;
+            if ( !isFraction )
+                exponent += 4;
+        }
+    }
+    if ( !hasDigits )
+        return false;
+    if ( p != last && ( *p | 0x20 ) == 'p' )
+    {
+        ++p;
+        const bool negativeExponent = p != last && *p == '-';
+        if ( p != last && ( *p == '-' || *p == '+' ) )
+            ++p;
+        if ( p == last )
+            return false;
+        // Larger exponents overflow or underflow anyway.
+        const std::int64_t maxExponent = 1 << 20;
+        std::int64_t e = 0;
+        for ( ; p != last && unsigned(*p - '0') < 10; ++p )
+            e = std::min( 10*e + (*p - '0'), maxExponent );
+        exponent += negativeExponent ? -e : e;
+    }
+    if ( p != last )
+        return false;
+    value = composeDouble( negative, mantissa, exponent, isInexact );
+    return true;
+}
+
+
+
+bool parseInteger( const char * first, const char * last,
+                   std::int64_t & value )
+{
+    auto p = first;
+    const bool negative = p != last && *p == '-';
+    if ( p != last && ( *p == '-' || *p == '+' ) )
+        ++p;
+    if ( p == last )
+        return false;
+    const auto maxMagnitude = std::uint64_t(
+                std::numeric_limits<std::int64_t>::max() ) + negative;
+    std::uint64_t magnitude = 0;
+    std::uint64_t eightDigits = 0;
+    while ( last - p >= 8 && parseEightDigits( p, eightDigits ) )
+    {
+        if ( magnitude > ( maxMagnitude - eightDigits ) / 100000000 )
+            return false;
+        magnitude = magnitude * 100000000 + eightDigits;
+        p += 8;
+    }
+    for ( ; p != last; ++p )
+    {
+        const auto digit = unsigned(*p - '0');
+        if ( digit >= 10 || magnitude > ( maxMagnitude - digit ) / 10 )
+            return false;
+        magnitude = 10*magnitude + digit;
+    }
+    // The negation is done in unsigned arithmetic, so that the smallest
+    // value does not overflow.
+    value = static_cast<std::int64_t>(
+                negative ? 0 - magnitude : magnitude );
+    return true;
+}
+
+
+bool parseInteger( const char * first, const char * last,
+                   std::int32_t & value )
+{
+    std::int64_t wide = 0;
+    if ( !parseInteger( first, last, wide ) ||
+         wide < std::numeric_limits<std::int32_t>::min() ||
+         wide > std::numeric_limits<std::int32_t>::max() )
+        return false;
+    value = static_cast<std::int32_t>( wide );
+    return true;
+}
+
+} // namespace conv
@@ -0,0 +1,153 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace conv
+{
+
+/// Types the values of a matrix can be stored as.
+enum class NumberType
+{
+    /// Only valid as an option: The narrowest type which holds the values
+    /// at the beginning of the file is chosen.
+    Detect,
+    Double,
+    Int32,
+    Int64,
+};
+
+/// Returns a text like "32 bit integers" for messages.
+const char * describe( NumberType numberType );
+
+/// Returns a text like "a 32 bit integer" for messages about a value of
+/// the type of the argument.
+const char * describeValue( double );
+const char * describeValue( std::int32_t );
+const char * describeValue( std::int64_t );
+
+
+/// Returns whether @c c separates two values on a line.
+inline bool isSeparator( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+/// Calls @c f(tokenFirst,tokenLast) for each token in the range
+/// @c [first,last) which is delimited by separators.
+template <typename F>
+void forEachToken( const char * first, const char * last, F && f )
+{
+    for (;;)
+    {
+        while ( first != last && isSeparator(*first) )
+            ++first;
+        if ( first == last )
+            return;
+        const auto tokenFirst = first;
+        while ( first != last && !isSeparator(*first) )
+            ++first;
+        f( tokenFirst, first );
+    }
+}
+
+
+/// Calls @c f(lineFirst,lineLast) for each line in the range
+/// @c [first,last) excluding the line breaks.
+///
+/// A last line without terminating line break is passed as well.
+template <typename F>
+void forEachLine( const char * first, const char * last, F && f )
+{
+    while ( first != last )
+    {
+        auto lineEnd = static_cast<const char *>(
+                    std::memchr( first, '\n', last - first ) );
+        if ( !lineEnd )
+            lineEnd = last;
+        f( first, lineEnd );
+        first = lineEnd == last ? last : lineEnd + 1;
+    }
+}
+
+
+/// Returns whether the range @c [first,last) consists of separators only.
+inline bool isBlank( const char * first, const char * last )
+{
+    for ( ; first != last; ++first )
+        if ( !isSeparator(*first) )
+            return false;
+    return true;
+}
+
+
+/// Parses the token @c [first,last) as a floating point number.
+///
+/// Returns @c false, if the token is not a number in its entirety.
+/// The parsing does not depend on the locale of the program and yields
+/// correctly rounded results.
+///
+/// Hexadecimal floating point numbers like "0x1.8p+1", as written by
+/// appendHexFloat(), are accepted as well. See parseHexFloat(). So are
+/// "nan", "inf" and "infinity" in any case and with an optional sign, as
+/// written by printf.
+bool parseDouble( const char * first, const char * last, double & value );
+
+
+/// Parses the token @c [first,last) as a hexadecimal floating point number
+/// with an optional sign, a "0x" prefix and an optional binary exponent.
+///
+/// Returns @c false, if the token is not such a number in its entirety.
+/// The hexadecimal digits are collected as the bits of a 64 bit integer,
+/// which is rounded to the bits of the double directly, so there is no
+/// decimal conversion and the result is correctly rounded.
+bool parseHexFloat( const char * first, const char * last, double & value );
+
+
+/// Returns whether the token @c [first,last) marks a missing value, i.e.
+/// it is empty or "NA", "N/A" or "null" in any case.
+///
+/// Like the tokens for special floating point values, these are looked up
+/// with a perfect hash, so at most one known token is compared.
+bool isMissingValue( const char * first, const char * last );
+
+
+/// Parses the token @c [first,last) as a decimal integer with an optional
+/// sign.
+///
+/// Returns @c false, if the token is not an integer in its entirety or if
+/// it does not fit into the type of @c value. Eight digits at a time are
+/// converted with a few arithmetic operations on a 64 bit word.
+bool parseInteger( const char * first, const char * last,
+                   std::int64_t & value );
+bool parseInteger( const char * first, const char * last,
+                   std::int32_t & value );
+
+
+/// Parses the token @c [first,last) as a number of the type of @c value.
+inline bool parseNumber( const char * first, const char * last,
+                         double & value )
+{
+    return parseDouble( first, last, value );
+}
+
+inline bool parseNumber( const char * first, const char * last,
+                         std::int64_t & value )
+{
+    return parseInteger( first, last, value );
+}
+
+inline bool parseNumber( const char * first, const char * last,
+                         std::int32_t & value )
+{
+    return parseInteger( first, last, value );
+}
+
+} // namespace conv
@@ -0,0 +1,218 @@
+#include "conv_perf_counters.h"
+
+#include "cpp_utils/std_make_unique.h"
+
+#include <vector>
+
+#ifdef __linux__
+#define CONV_HAS_PERF_EVENTS 1
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace conv
+{
+
+PerfCounts & PerfCounts::operator+=( const PerfCounts & other )
+{
+    cycles       += other.cycles;
+    instructions += other.instructions;
+    cacheMisses  += other.cacheMisses;
+    branchMisses += other.branchMisses;
+    dtlbMisses   += other.dtlbMisses;
+    return *this;
+}
+
+
+double PerfCounts::ipc() const
+{
+    return cycles ? double( instructions ) / cycles : 0.;
+}
+
+
+#ifdef CONV_HAS_PERF_EVENTS
+
+namespace
+{
+
+// The counted events in the order of the members of PerfCounts.
+const std::size_t nEvents = 5;
+
+perf_event_attr eventAttributes( std::size_t event )
+{
+    perf_event_attr attr;
+    std::memset( &attr, 0, sizeof(attr) );
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    switch ( event )
+    {
+    case 0:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case 1:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case 2:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case 3:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) |
+                ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+        break;
+    }
+    return attr;
+}
+
+
+// Returns the ids of all threads of the process.
+std::vector<pid_t> threadIds()
+{
+    std::vector<pid_t> ids;
+    const auto dir = ::opendir( "/proc/self/task" );
+    if ( !dir )
+        return ids;
+    while ( const auto entry = ::readdir( dir ) )
+        if ( entry->d_name[0] != '.' )
+            ids.push_back( static_cast<pid_t>(
+                               std::atoi( entry->d_name ) ) );
+    ::closedir( dir );
+    return ids;
+}
+
+} // unnamed namespace
+
+
+struct PerfCounters::Impl
+{
+    // file descriptors of the counters of each event on each thread
+    std::vector<int> fds[nEvents];
+};
+
+
+PerfCounters::PerfCounters()
+{
+    m = std::make_unique<Impl>();
+    for ( const auto tid : threadIds() )
+    {
+        for ( std::size_t event = 0; event < nEvents; ++event )
+        {
+            auto attr = eventAttributes( event );
+            const auto fd = static_cast<int>( ::syscall(
+                    SYS_perf_event_open, &attr, tid, -1, -1, 0 ) );
+            // Events which are not supported are left out.
+            if ( fd != -1 )
+                m->fds[event].push_back( fd );
+        }
+    }
+}
+
+
+PerfCounters::~PerfCounters()
+{
+    for ( const auto & fds : m->fds )
+        for ( const auto fd : fds )
+            ::close( fd );
+}
+
+
+bool PerfCounters::isAvailable() const
+{
+    return !m->fds[0].empty();
+}
+
+
+void PerfCounters::start()
+{
+    for ( const auto & fds : m->fds )
+        for ( const auto fd : fds )
+        {
+            ::ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+            ::ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+        }
+}
+
+
+PerfCounts PerfCounters::stop()
+{
+    for ( const auto & fds : m->fds )
+        for ( const auto fd : fds )
+            ::ioctl( fd, PERF_EVENT_IOC_DISABLE, 0 );
+    std::uint64_t totals[nEvents] = {};
+    for ( std::size_t event = 0; event < nEvents; ++event )
+        for ( const auto fd : m->fds[event] )
+        {
+            // value, time enabled, time running
+            std::uint64_t values[3] = {};
+            if ( ::read( fd, values, sizeof(values) ) !=
+                     static_cast<ssize_t>( sizeof(values) ) ||
+                 values[2] == 0 )
+                continue;
+            totals[event] += values[2] == values[1]
+                    ? values[0]
+                    : std::uint64_t( double( values[0] ) *
+                                     values[1] / values[2] );
+        }
+    PerfCounts counts;
+    counts.cycles       = totals[0];
+    counts.instructions = totals[1];
+    counts.cacheMisses  = totals[2];
+    counts.branchMisses = totals[3];
+    counts.dtlbMisses   = totals[4];
+    return counts;
+}
+
+#else
+
+struct PerfCounters::Impl
+{
+};
+
+
+PerfCounters::PerfCounters()
+{
+    m = std::make_unique<Impl>();
+}
+
+
+PerfCounters::~PerfCounters()
+{
+}
+
+
+bool PerfCounters::isAvailable() const
+{
+    return false;
+}
+
+
+void PerfCounters::start()
+{
+}
+
+
+PerfCounts PerfCounters::stop()
+{
+    return PerfCounts();
+}
+
+#endif
+
+} // namespace conv
@@ -0,0 +1,62 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace conv
+{
+
+/// Numbers of hardware events counted by the processor.
+struct PerfCounts
+{
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cacheMisses = 0;
+    std::uint64_t branchMisses = 0;
+    std::uint64_t dtlbMisses = 0;
+
+    PerfCounts & operator+=( const PerfCounts & other );
+
+    /// Instructions per cycle.
+    double ipc() const;
+};
+
+
+/// Counts hardware events on all threads of the process with the Linux
+/// @c perf_event_open() interface.
+///
+/// Only the user space part of the threads is measured. If the
+/// processor multiplexes its counters, then the counts are extrapolated
+/// to the whole measuring time. On other systems, or if the kernel does
+/// not permit counting (see @c /proc/sys/kernel/perf_event_paranoid),
+/// the counters are not available and all counts are zero.
+class PerfCounters
+{
+public:
+    /// Opens counters for all threads which exist at this point, e.g. the
+    /// workers of the thread pool. Threads started later are not counted.
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters( const PerfCounters & ) = delete;
+    PerfCounters & operator=( const PerfCounters & ) = delete;
+
+    bool isAvailable() const;
+
+    /// Resets the counts to zero and starts counting.
+    void start();
+
+    /// Stops counting and returns the counts since start().
+    PerfCounts stop();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m;
+};
+
+} // namespace conv
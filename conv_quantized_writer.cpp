@@ -0,0 +1,83 @@
+#include "conv_quantized_writer.h"
+
+#include "conv_encoding.h"
+
+#include <ostream>
+
+namespace conv
+{
+
+ValueRange unite( const std::vector<ValueRange> & ranges )
+{
+    ValueRange result;
+    for ( const auto & range : ranges )
+        result.include( range );
+    return result;
+}
+
+
+namespace detail
+{
+
+QuantizationParams quantizationParams( const std::vector<ValueRange> & ranges,
+                                       QuantizedType type )
+{
+    const double maxSteps = type == QuantizedType::Int16 ? 65535. : 255.;
+    const double qMin = type == QuantizedType::Int16 ? -32768. : 0.;
+    QuantizationParams params;
+    for ( auto range : ranges )
+    {
+        // Columns without finite values are mapped to zero.
+        if ( range.min > range.max )
+            range.min = range.max = 0;
+        auto scale = ( range.max - range.min ) / maxSteps;
+        if ( scale == 0 )
+            scale = 1;
+        params.mins.push_back( range.min );
+        params.invScales.push_back( 1 / scale );
+        params.scales.push_back( scale );
+        params.offsets.push_back( range.min - qMin * scale );
+    }
+    return params;
+}
+
+
+void writeQuantizedHeader( std::ostream & file, QuantizedType type,
+                           std::uint64_t nRows, std::uint64_t nCols,
+                           const QuantizationParams & params )
+{
+    std::string header = "CMQUANT1";
+    appendLittleEndian( header, type == QuantizedType::Int16 ? 1 : 2, 4 );
+    appendLittleEndian( header, params.scales.size(), 4 );
+    appendLittleEndian( header, nRows, 8 );
+    appendLittleEndian( header, nCols, 8 );
+    for ( std::size_t k = 0; k < params.scales.size(); ++k )
+    {
+        appendLittleEndian( header, params.scales[k] );
+        appendLittleEndian( header, params.offsets[k] );
+    }
+    file.write( header.data(), header.size() );
+}
+
+
+void toLittleEndian( std::int16_t * values, std::size_t n )
+{
+    if ( isLittleEndian() )
+        return;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        const auto u = static_cast<std::uint16_t>( values[i] );
+        values[i] = static_cast<std::int16_t>( ( u >> 8 ) | ( u << 8 ) );
+    }
+}
+
+
+void throwQuantizedWriteError( const std::string & fileName )
+{
+    CU_THROW( "Failed to write the quantized matrix to the file '" +
+              fileName + "'." );
+}
+
+} // namespace detail
+
+} // namespace conv
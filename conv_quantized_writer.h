@@ -0,0 +1,274 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_matrix_view.h"
+#include "conv_matrix_writer.h"
+#include "conv_parallel.h"
+#include "conv_trace.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// Integer types values can be quantized to.
+enum class QuantizedType
+{
+    Int16,
+    UInt8,
+};
+
+
+/// Range of the values which are mapped to the integers.
+struct ValueRange
+{
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    /// Extends the range, such that it contains @c value. NaN is ignored.
+    void include( double value )
+    {
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+
+    void include( const ValueRange & other )
+    {
+        include( other.min );
+        include( other.max );
+    }
+};
+
+
+/// Returns the range of the finite values in each column of the matrix.
+/// The rows are processed in parallel.
+template <typename T, bool isTransposed>
+std::vector<ValueRange> columnRanges(
+        const StridedView<T, isTransposed> & matrix )
+{
+    const TraceScope trace( "column ranges" );
+    const std::size_t rowsPerBlock = 1024;
+    const auto nBlocks = ( matrix.nRows() + rowsPerBlock - 1 ) / rowsPerBlock;
+    std::vector<std::vector<ValueRange>> blockRanges(
+                nBlocks, std::vector<ValueRange>( matrix.nCols() ) );
+    parallelFor( 0, nBlocks, [&]( std::size_t block )
+    {
+        auto & ranges = blockRanges[block];
+        const auto first = block * rowsPerBlock;
+        const auto last = std::min( first + rowsPerBlock, matrix.nRows() );
+        for ( auto i = first; i != last; ++i )
+            for ( std::size_t j = 0; j < matrix.nCols(); ++j )
+            {
+                const double value = matrix(i,j);
+                if ( std::isfinite( value ) )
+                    ranges[j].include( value );
+            }
+    } );
+    std::vector<ValueRange> ranges( matrix.nCols() );
+    for ( const auto & block : blockRanges )
+        for ( std::size_t j = 0; j < ranges.size(); ++j )
+            ranges[j].include( block[j] );
+    return ranges;
+}
+
+
+/// Returns a range which contains all the given ranges.
+ValueRange unite( const std::vector<ValueRange> & ranges );
+
+
+namespace detail
+{
+
+// Maps values to integers by q = round( (value - min) * invScale ) + qMin.
+struct QuantizationParams
+{
+    std::vector<double> invScales;
+    std::vector<double> mins;
+    // value = offset + scale * q
+    std::vector<double> scales;
+    std::vector<double> offsets;
+};
+
+QuantizationParams quantizationParams( const std::vector<ValueRange> & ranges,
+                                       QuantizedType type );
+
+// Writes the header of a quantized file. See QuantizedMatrixWriter.
+void writeQuantizedHeader( std::ostream & file, QuantizedType type,
+                           std::uint64_t nRows, std::uint64_t nCols,
+                           const QuantizationParams & params );
+
+// Converts the integers to little endian byte order in place.
+void toLittleEndian( std::int16_t * values, std::size_t n );
+inline void toLittleEndian( std::uint8_t *, std::size_t ) {}
+
+void throwQuantizedWriteError( const std::string & fileName );
+
+
+// Quantizes a row of values. The loop has no branches, so it can be
+// vectorized. NaN ends up as the smallest integer, infinities are clamped.
+template <typename Q, typename T>
+void quantizeRow( const T * values, std::size_t n,
+                  const double * mins, const double * invScales,
+                  double maxSteps, Q * out )
+{
+    const auto qMin = double( std::numeric_limits<Q>::min() );
+    for ( std::size_t j = 0; j < n; ++j )
+    {
+        auto u = ( double( values[j] ) - mins[j] ) * invScales[j];
+        u = u > 0. ? u : 0.;
+        u = u < maxSteps ? u : maxSteps;
+        out[j] = Q( std::int32_t( u + 0.5 ) + std::int32_t( qMin ) );
+    }
+}
+
+} // namespace detail
+
+
+/// Writes a matrix as integers which approximate the values by
+/// value = offset + scale * q.
+///
+/// All numbers are stored in little endian byte order:
+/// - 8 bytes "CMQUANT1"
+/// - uint8 type of the integers (1 for int16, 2 for uint8), 3 bytes padding
+/// - uint32 number of (scale, offset) pairs, which is one for each column
+///   if the writer quantizes per column and the matrix has columns, and
+///   one for the whole matrix otherwise
+/// - uint64 number of rows and uint64 number of columns
+/// - the pairs as two doubles each
+/// - the integers row by row
+///
+/// The header is written when the first rows arrive, or by finish() if
+/// there are none. The number of rows is filled in by finish().
+template <typename T>
+class QuantizedMatrixWriter : public MatrixWriter<T>
+{
+public:
+    /// @c ranges contains either a single range for all values or one
+    /// range for each column. If @c isPerColumn is set, then a single
+    /// range, e.g. a fixed one, is written as the pair of each column.
+    QuantizedMatrixWriter( const std::string & fileName, QuantizedType type,
+                           const std::vector<ValueRange> & ranges,
+                           bool isPerColumn )
+        : fileName( fileName )
+        , type( type )
+        , ranges( ranges )
+        , isPerColumn( isPerColumn )
+        , file( fileName, std::ios::binary )
+    {
+        if ( !file.good() )
+            detail::throwQuantizedWriteError( fileName );
+    }
+
+    void append( const StridedView<T> & rows ) override
+    {
+        if ( type == QuantizedType::Int16 )
+            appendQuantized<std::int16_t>( rows );
+        else
+            appendQuantized<std::uint8_t>( rows );
+    }
+
+    void finish() override
+    {
+        if ( !isStarted )
+            start( 0 );
+        file.seekp( 0 );
+        detail::writeQuantizedHeader( file, type, nWrittenRows, nCols,
+                                      params );
+        file.flush();
+        if ( !file.good() )
+            detail::throwQuantizedWriteError( fileName );
+    }
+
+private:
+    template <typename Q>
+    void appendQuantized( const StridedView<T> & rows )
+    {
+        if ( !isStarted )
+            start( rows.nCols() );
+        const auto maxSteps = double( std::numeric_limits<Q>::max() ) -
+                              double( std::numeric_limits<Q>::min() );
+        // Blocks of rows are quantized in parallel and written in order
+        // like in appendText(), so the buffer stays small.
+        const auto rowsPerBlock = std::max<std::size_t>(
+                    ( 1 << 16 ) / ( sizeof(Q) * nCols + 1 ), 1 );
+        const auto rowsPerRound =
+                rowsPerBlock * 4 * ThreadPool::instance().nThreads();
+        std::vector<Q> buffer( std::min( rowsPerRound, rows.nRows() ) * nCols );
+        for ( std::size_t roundStart = 0; roundStart < rows.nRows();
+              roundStart += rowsPerRound )
+        {
+            const auto roundEnd =
+                    std::min( roundStart + rowsPerRound, rows.nRows() );
+            const auto nBlocks =
+                    ( roundEnd - roundStart + rowsPerBlock - 1 ) / rowsPerBlock;
+            parallelFor( 0, nBlocks, [&]( std::size_t k )
+            {
+                const auto first = roundStart + k*rowsPerBlock;
+                const TraceScope trace( "quantize", first / rowsPerBlock );
+                const auto last = std::min( first + rowsPerBlock, roundEnd );
+                const auto out = &buffer[( first - roundStart ) * nCols];
+                for ( auto i = first; i != last; ++i )
+                    detail::quantizeRow( &rows(i,0), nCols,
+                                         params.mins.data(),
+                                         params.invScales.data(), maxSteps,
+                                         out + ( i - first ) * nCols );
+                detail::toLittleEndian( out, ( last - first ) * nCols );
+            } );
+            const TraceScope trace( "write quantized",
+                                    roundStart / rowsPerRound );
+            file.write( reinterpret_cast<const char *>( buffer.data() ),
+                        ( roundEnd - roundStart ) * nCols * sizeof(Q) );
+            if ( !file.good() )
+                detail::throwQuantizedWriteError( fileName );
+        }
+        nWrittenRows += rows.nRows();
+    }
+
+    // Writes a preliminary header and expands a single range to all
+    // columns, so the quantization loop has no special case.
+    void start( std::size_t nCols_ )
+    {
+        isStarted = true;
+        nCols = nCols_;
+        // A matrix without columns still gets a pair for the whole matrix.
+        if ( nCols == 0 )
+            ranges.resize( 1 );
+        else if ( isPerColumn && ranges.size() == 1 )
+            ranges.assign( nCols, ranges.front() );
+        params = detail::quantizationParams( ranges, type );
+        detail::writeQuantizedHeader( file, type, 0, nCols, params );
+        if ( params.mins.size() == 1 )
+        {
+            params.mins.assign( nCols, params.mins.front() );
+            params.invScales.assign( nCols, params.invScales.front() );
+        }
+        if ( params.mins.size() != nCols )
+            CU_THROW( "The number of quantization ranges does not match "
+                      "the number of columns." );
+    }
+
+    std::string fileName;
+    QuantizedType type;
+    std::vector<ValueRange> ranges;
+    bool isPerColumn;
+    std::ofstream file;
+    bool isStarted = false;
+    detail::QuantizationParams params;
+    std::size_t nCols = 0;
+    std::size_t nWrittenRows = 0;
+};
+
+} // namespace conv
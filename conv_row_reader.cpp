@@ -0,0 +1,559 @@
+#include "conv_row_reader.h"
+
+#include "conv_mapped_file.h"
+#include "conv_parallel.h"
+#include "conv_parsing.h"
+#include "conv_trace.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace conv
+{
+
+namespace
+{
+
+// Minimum number of characters which are parsed by a single task.
+const std::size_t minPieceSize = 1 << 16;
+
+// Marks that no faulty line or row has been found.
+const std::size_t noError = std::numeric_limits<std::size_t>::max();
+
+// Returns the position after the line break which ends the line
+// containing @c p.
+const char * endOfLine( const char * p, const char * last )
+{
+    if ( p == last )
+        return last;
+    const auto lineBreak = static_cast<const char *>(
+                std::memchr( p, '\n', last - p ) );
+    return lineBreak ? lineBreak + 1 : last;
+}
+
+
+// Range of the numbers of values in non-blank lines.
+struct RowLengths
+{
+    std::size_t min = noError;
+    std::size_t max = 0;
+
+    void add( const RowLengths & other )
+    {
+        min = std::min( min, other.min );
+        max = std::max( max, other.max );
+    }
+
+    void add( std::size_t length )
+    {
+        min = std::min( min, length );
+        max = std::max( max, length );
+    }
+};
+
+
+std::size_t countValues( const char * first, const char * last )
+{
+    std::size_t n = 0;
+    forEachToken( first, last, [&]( const char *, const char * )
+    {
+        ++n;
+    } );
+    return n;
+}
+
+
+// Returns the range of the lengths of the non-blank lines in
+// @c [first,last). The lines are scanned in parallel and released.
+RowLengths scanRowLengths( const MappedFile & file,
+                           const char * first, const char * last )
+{
+    const TraceScope trace( "scan row lengths" );
+    const auto nPieces = std::max<std::size_t>( std::min<std::size_t>(
+                4 * ThreadPool::instance().nThreads(),
+                ( last - first ) / minPieceSize ), 1 );
+    std::vector<RowLengths> lengths( nPieces );
+    parallelFor( 0, nPieces, [&]( std::size_t k )
+    {
+        const auto pieceFirst =
+                endOfLine( first + ( last - first ) * k / nPieces, last );
+        const auto pieceLast =
+                endOfLine( first + ( last - first ) * (k+1) / nPieces, last );
+        forEachLine( k == 0 ? first : pieceFirst, pieceLast,
+                     [&]( const char * lineFirst, const char * lineLast )
+        {
+            if ( !isBlank( lineFirst, lineLast ) )
+                lengths[k].add( countValues( lineFirst, lineLast ) );
+        } );
+        file.release( k == 0 ? first : pieceFirst, pieceLast );
+    } );
+    RowLengths result;
+    for ( const auto & piece : lengths )
+        result.add( piece );
+    return result;
+}
+
+} // unnamed namespace
+
+
+RowReader::RowReader( const MappedFile & file, FileHeader header,
+                      FixedWidthLayout layout,
+                      MissingValueRules missingValueRules,
+                      BadLines badLines, std::size_t maxParseErrors )
+    : file( file )
+    , header( std::move( header ) )
+    , layout( std::move( layout ) )
+    , missingValueRules( missingValueRules )
+    , badLines( badLines )
+    , maxParseErrors( maxParseErrors )
+{
+    rewind();
+}
+
+
+void RowReader::addParseErrors( const std::vector<ParseError> & newErrors,
+                                std::size_t firstLine )
+{
+    nErrors += newErrors.size();
+    for ( auto error : newErrors )
+    {
+        if ( errors.size() >= maxParseErrors )
+            return;
+        error.line += firstLine;
+        errors.push_back( error );
+    }
+}
+
+
+template <typename T>
+std::size_t RowReader::readFixedWidthBlock(
+        std::size_t maxBytes, const RowStorage<T> & storage,
+        std::size_t firstCol, std::size_t lastCol )
+{
+    // The rows are the lines, whose positions are known without scanning
+    // the text.
+    const auto dataBegin = file.begin() + header.size;
+    const auto firstRow = std::size_t( pos - dataBegin ) / layout.lineLength;
+    const auto nRows = std::min(
+                ( std::max<std::size_t>( maxBytes, 1 ) + layout.lineLength
+                  - 1 ) / layout.lineLength,
+                nFixedWidthRows( file, header, layout ) - firstRow );
+    cols = layout.widths.size();
+    lastCol = std::min( lastCol, cols );
+    firstCol = std::min( firstCol, lastCol );
+    if ( nRows == 0 )
+    {
+        pos = file.end();
+        return 0;
+    }
+    const auto values = storage( nRows, lastCol - firstCol );
+    const auto nMissing = missing.size();
+    std::vector<ParseError> blockErrors;
+    const auto nStoredRows = readFixedWidthRows(
+                file, header, layout, missingValueRules, badLines,
+                firstRow, firstRow + nRows, firstCol, lastCol, values,
+                missing, blockErrors );
+    addParseErrors( blockErrors, 0 );
+    for ( auto i = nMissing; i < missing.size(); ++i )
+        missing[i].row += nRowsRead;
+    const auto last = std::min(
+                dataBegin + ( firstRow + nRows ) * layout.lineLength,
+                file.end() );
+    file.release( pos, last );
+    pos = last;
+    nLinesRead += nRows;
+    nRowsRead += nStoredRows;
+    return nStoredRows;
+}
+
+
+template <typename T>
+std::size_t RowReader::readRows(
+        std::size_t maxBytes, const RowStorage<T> & storage,
+        std::size_t firstCol, std::size_t lastCol )
+{
+    if ( !layout.isEmpty() )
+        return readFixedWidthBlock( maxBytes, storage, firstCol, lastCol );
+    const auto last = endOfLine(
+                pos + std::min<std::size_t>( maxBytes, file.end() - pos ),
+                file.end() );
+
+    // Split the text into pieces of lines which are processed in parallel.
+    // Errors are recorded and thrown afterwards, so that the first one in
+    // the file is reported.
+    struct Piece
+    {
+        const char * first;
+        const char * last;
+        std::size_t nLines = 0;
+        // number of non-blank lines
+        std::size_t nRows = 0;
+        // zero-based index of the first line or row which is faulty
+        std::size_t badLine = noError;
+        std::size_t badRow = noError;
+        // whether the faulty line contains a number which does not fit
+        // into T
+        bool isUnfit = false;
+        // positions of the missing values with the rows counted from the
+        // first row of the piece
+        std::vector<MissingValue> missing;
+        // lengths of the rows, if they are needed for ragged rows
+        RowLengths lengths;
+        // lines which have been replaced or dropped in a lenient mode with
+        // the lines counted from the first line of the piece
+        std::vector<ParseError> errors;
+        std::size_t nDropped = 0;
+    };
+    const auto nPieces = std::max<std::size_t>( std::min<std::size_t>(
+                4 * ThreadPool::instance().nThreads(),
+                ( last - pos ) / minPieceSize ), 1 );
+    std::vector<Piece> pieces( nPieces );
+    auto pieceFirst = pos;
+    for ( std::size_t k = 0; k < nPieces; ++k )
+    {
+        pieces[k].first = pieceFirst;
+        pieceFirst = endOfLine( pos + ( last - pos ) * (k+1) / nPieces,
+                                last );
+        pieceFirst = std::max( pieceFirst, pieces[k].first );
+        pieces[k].last = pieceFirst;
+    }
+
+    // Count the rows, so that the place of each value is known. The width
+    // of ragged rows depends on all rows, so their lengths are needed
+    // before the first row is stored.
+    const auto policy = missingValueRules.raggedRows;
+    const auto needsLengths = cols == 0 && policy != RaggedRows::Error;
+    parallelFor( 0, nPieces, [&]( std::size_t k )
+    {
+        const TraceScope trace( "count rows", k );
+        auto & piece = pieces[k];
+        forEachLine( piece.first, piece.last,
+                     [&]( const char * lineFirst, const char * lineLast )
+        {
+            ++piece.nLines;
+            if ( isBlank( lineFirst, lineLast ) )
+                return;
+            ++piece.nRows;
+            if ( needsLengths )
+                piece.lengths.add( countValues( lineFirst, lineLast ) );
+        } );
+    } );
+    std::size_t nRows = 0;
+    for ( const auto & piece : pieces )
+        nRows += piece.nRows;
+    if ( nRows == 0 )
+    {
+        for ( const auto & piece : pieces )
+            nLinesRead += piece.nLines;
+        file.release( pos, last );
+        pos = last;
+        return 0;
+    }
+    if ( needsLengths )
+    {
+        // The rest of the file is scanned only, if the rows are read in
+        // blocks.
+        RowLengths lengths;
+        for ( const auto & piece : pieces )
+            lengths.add( piece.lengths );
+        if ( last != file.end() )
+            lengths.add( scanRowLengths( file, last, file.end() ) );
+        cols = policy == RaggedRows::Truncate ? lengths.min : lengths.max;
+    }
+    else if ( cols == 0 )
+    {
+        // The first row determines the number of columns.
+        forEachLine( pos, last,
+                     [&]( const char * lineFirst, const char * lineLast )
+        {
+            if ( cols != 0 )
+                return;
+            forEachToken( lineFirst, lineLast,
+                          [&]( const char *, const char * )
+            {
+                ++cols;
+            } );
+        } );
+    }
+    lastCol = std::min( lastCol, cols );
+    firstCol = std::min( firstCol, lastCol );
+    const auto width = lastCol - firstCol;
+    const auto values = storage( nRows, width );
+    T fillValue = 0;
+    const auto canFill = fillMissingValue( missingValueRules, fillValue );
+    const auto isPadded =
+            policy == RaggedRows::Pad || policy == RaggedRows::Sparse;
+    const auto isLenient = badLines != BadLines::Abort;
+    const auto canReplace = badLines == BadLines::Drop ||
+            ( badLines == BadLines::Fill && canFill );
+
+    // Parse the values to their places. The pieces are consecutive rows
+    // of the result, so each NUMA node writes a contiguous block.
+    std::vector<std::size_t> firstRows;
+    std::size_t firstRow = 0;
+    for ( const auto & piece : pieces )
+    {
+        firstRows.push_back( firstRow );
+        firstRow += piece.nRows;
+    }
+    parallelForOnNodes( 0, nPieces, [&]( std::size_t k )
+    {
+        const TraceScope trace( "parse rows", k );
+        auto & piece = pieces[k];
+        auto row = values + firstRows[k] * width;
+        std::size_t iLine = 0;
+        std::size_t iRow = 0;
+
+        // Actions for the rare rows which are not regular.
+        const auto keepRow = [&]
+        {
+            row += width;
+            ++iRow;
+        };
+        const auto dropRow = [&]
+        {
+            // The row is overwritten by the next one.
+            while ( !piece.missing.empty() &&
+                    piece.missing.back().row == iRow )
+                piece.missing.pop_back();
+            ++piece.nDropped;
+        };
+        const auto padRow = [&]( std::size_t nValues, bool isMissing )
+        {
+            for ( auto col = std::max( nValues, firstCol ); col < lastCol;
+                  ++col )
+            {
+                row[col-firstCol] = fillValue;
+                if ( isMissing )
+                    piece.missing.push_back( { iRow, col } );
+            }
+        };
+
+        forEachLine( piece.first, piece.last,
+                     [&]( const char * lineFirst, const char * lineLast )
+        {
+            if ( piece.badLine != noError || piece.badRow != noError )
+                return;
+            std::size_t j = 0;
+            bool isValid = true;
+            bool isUnfit = false;
+            // first field which has been replaced in a lenient mode
+            std::size_t badField = 0;
+            const char * badFieldFirst = nullptr;
+            forEachToken( lineFirst, lineLast,
+                          [&]( const char * first, const char * last )
+            {
+                T value = 0;
+                const auto isInBand = j >= firstCol && j < lastCol;
+                if ( isValid && !parseNumber( first, last, value ) )
+                {
+                    // Tell apart missing values and numbers which do not
+                    // fit into T.
+                    const auto kind = classifyNonNumber(
+                                first, last, missingValueRules, value );
+                    if ( kind == NonNumber::Missing )
+                    {
+                        if ( isInBand )
+                            piece.missing.push_back( { iRow, j } );
+                    }
+                    else if ( kind == NonNumber::Invalid && canReplace )
+                    {
+                        if ( badField == 0 )
+                        {
+                            badField = j + 1;
+                            badFieldFirst = first;
+                        }
+                        value = fillValue;
+                        if ( isInBand && badLines == BadLines::Fill )
+                            piece.missing.push_back( { iRow, j } );
+                    }
+                    else
+                    {
+                        // A lenient mode only gets here, if the fill value
+                        // does not fit into T.
+                        isValid = false;
+                        isUnfit = kind == NonNumber::Unfit || isLenient;
+                    }
+                }
+                else if ( !isValid && isUnfit && !isLenient )
+                    isUnfit = classifyNonNumber(
+                                first, last, missingValueRules, value ) !=
+                            NonNumber::Invalid;
+                if ( isInBand )
+                    row[j-firstCol] = value;
+                ++j;
+            } );
+            if ( !isValid )
+            {
+                piece.badLine = iLine;
+                piece.isUnfit = isUnfit;
+            }
+            else if ( badField != 0 )
+            {
+                // The length is reported as well, if it is wrong, too.
+                const auto hasValidLength = j == cols ||
+                        ( j < cols && isPadded ) ||
+                        ( j > cols && policy == RaggedRows::Truncate );
+                piece.errors.push_back( {
+                    ParseErrorKind::NotANumber, iLine, badField,
+                    std::size_t( badFieldFirst - file.begin() ),
+                    hasValidLength ? cols : j } );
+                if ( badLines == BadLines::Drop )
+                    dropRow();
+                else
+                {
+                    padRow( j, true );
+                    keepRow();
+                }
+            }
+            else if ( j != 0 && j != cols )
+            {
+                // Rows of other lengths are rare, so the policies are only
+                // checked for them.
+                const auto needsFill = j < cols &&
+                        ( isPadded || badLines == BadLines::Fill );
+                if ( needsFill && !canFill )
+                {
+                    piece.badLine = iLine;
+                    piece.isUnfit = true;
+                }
+                else if ( j < cols && isPadded )
+                {
+                    padRow( j, policy == RaggedRows::Sparse );
+                    keepRow();
+                }
+                else if ( j > cols && policy == RaggedRows::Truncate )
+                    keepRow();
+                else if ( isLenient )
+                {
+                    piece.errors.push_back( {
+                        ParseErrorKind::WrongLength, iLine, 0,
+                        std::size_t( lineFirst - file.begin() ), j } );
+                    if ( badLines == BadLines::Drop )
+                        dropRow();
+                    else
+                    {
+                        padRow( j, true );
+                        keepRow();
+                    }
+                }
+                else
+                    piece.badRow = iRow;
+            }
+            else if ( j != 0 )
+                keepRow();
+            ++iLine;
+        } );
+        file.release( piece.first, piece.last );
+    } );
+
+    // Report the first error in the file. The rows of each piece follow
+    // those of the previous one, if rows have been dropped.
+    std::size_t nStoredRows = 0;
+    for ( std::size_t k = 0; k < nPieces; ++k )
+    {
+        const auto & piece = pieces[k];
+        if ( piece.badLine != noError && piece.isUnfit )
+            throw UnfitValueError(
+                    "Line " +
+                    std::to_string( nLinesRead + piece.badLine + 1 ) +
+                    " in file '" + file.fileName() + "' contains a value "
+                    "which is not " + describeValue( T() ) + "." );
+        if ( piece.badLine != noError )
+            CU_THROW( "Line " +
+                      std::to_string( nLinesRead + piece.badLine + 1 ) +
+                      " in file '" + file.fileName() +
+                      "' could not be parsed to the end." );
+        if ( piece.badRow != noError )
+            CU_THROW( "Row " +
+                      std::to_string( nRowsRead + piece.badRow + 1 ) +
+                      " of the matrix contains a different number of "
+                      "samples than the first row." );
+        const auto nPieceRows = piece.nRows - piece.nDropped;
+        if ( nStoredRows != firstRows[k] && nPieceRows != 0 )
+            std::memmove( values + nStoredRows * width,
+                          values + firstRows[k] * width,
+                          nPieceRows * width * sizeof(T) );
+        for ( auto missingValue : piece.missing )
+        {
+            missingValue.row += nRowsRead;
+            missing.push_back( missingValue );
+        }
+        addParseErrors( piece.errors, nLinesRead + 1 );
+        nStoredRows += nPieceRows;
+        nLinesRead += piece.nLines;
+        nRowsRead += nPieceRows;
+    }
+    pos = last;
+    return nStoredRows;
+}
+
+
+template std::size_t RowReader::readRows<double>(
+        std::size_t, const RowStorage<double> &, std::size_t, std::size_t );
+template std::size_t RowReader::readRows<std::int32_t>(
+        std::size_t, const RowStorage<std::int32_t> &,
+        std::size_t, std::size_t );
+template std::size_t RowReader::readRows<std::int64_t>(
+        std::size_t, const RowStorage<std::int64_t> &,
+        std::size_t, std::size_t );
+
+
+bool RowReader::atEnd() const
+{
+    return pos == file.end();
+}
+
+
+void RowReader::rewind()
+{
+    pos = file.begin() + header.size;
+    nLinesRead = header.nLines;
+    nRowsRead = 0;
+    errors.clear();
+    nErrors = 0;
+}
+
+
+std::size_t RowReader::nCols() const
+{
+    return cols;
+}
+
+
+std::size_t RowReader::nRows() const
+{
+    return nRowsRead;
+}
+
+
+std::size_t RowReader::nLines() const
+{
+    return nLinesRead - header.nLines;
+}
+
+
+const std::vector<MissingValue> & RowReader::missingValues() const
+{
+    return missing;
+}
+
+
+const std::vector<ParseError> & RowReader::parseErrors() const
+{
+    return errors;
+}
+
+
+std::size_t RowReader::nParseErrors() const
+{
+    return nErrors;
+}
+
+} // namespace conv
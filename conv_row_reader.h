@@ -0,0 +1,178 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_fixed_width.h"
+#include "conv_header.h"
+#include "conv_missing_values.h"
+#include "conv_parse_errors.h"
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+class MappedFile;
+
+/// Provides storage for the values of @c nRows rows with @c nCols values
+/// each in row-major order.
+template <typename T>
+using RowStorage =
+        std::function<T *( std::size_t nRows, std::size_t nCols )>;
+
+
+/// Thrown by RowReader, if a value is a number, but does not fit into the
+/// integer type which the values are parsed to.
+class UnfitValueError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+
+/// Parses the rows of a matrix file block by block.
+///
+/// The lines of a block are counted first, so that the values can be
+/// parsed in parallel directly to their final place. No copy of the text
+/// or of the values is made. The characters which have been read are
+/// released, so the resident memory does not grow with the size of the
+/// file. Errors are reported with the line and row numbers in the whole
+/// file.
+///
+/// The rows start after the header of the file. If the file has
+/// fixed-width fields, then each line is a row and the values are fetched
+/// from their fields by readFixedWidthRows() instead. Missing values are
+/// filled according to the rules and their positions are collected.
+///
+/// In the lenient modes for bad lines, each task of the parser collects
+/// the faulty lines it finds in its own list and goes on. These lists are
+/// merged after all lines of a block have been parsed. Only lines which
+/// fail to parse take this way, so clean files are parsed as fast as in
+/// the strict mode.
+class RowReader
+{
+public:
+    /// The file must stay alive as long as the reader is used. An empty
+    /// layout means that the values are separated by spaces. Only the
+    /// first @c maxParseErrors bad lines are kept, the others are only
+    /// counted.
+    explicit RowReader(
+            const MappedFile & file,
+            FileHeader header = FileHeader(),
+            FixedWidthLayout layout = FixedWidthLayout(),
+            MissingValueRules missingValueRules = MissingValueRules(),
+            BadLines badLines = BadLines::Abort,
+            std::size_t maxParseErrors =
+                std::numeric_limits<std::size_t>::max() );
+
+    /// Parses the rows in the next @c maxBytes characters, rounded up to
+    /// the end of a line, and stores the values in the columns
+    /// @c [firstCol,lastCol) of each row in the memory provided by
+    /// @c storage.
+    ///
+    /// @c T can be @c double, @c std::int32_t or @c std::int64_t.
+    /// Returns the number of rows which have been read. Throws, if a line
+    /// is not a row of numbers or if a row contains a different number of
+    /// values than the first row, unless the rules allow ragged rows or
+    /// bad lines. Throws UnfitValueError, if a value does not fit into
+    /// @c T. If bad lines are dropped, then fewer rows than requested from
+    /// @c storage may be stored.
+    ///
+    /// Ragged rows are padded or truncated to the length of the longest or
+    /// shortest row in the whole file. If the first call does not read
+    /// the whole file, then it scans the rest of the file for the lengths
+    /// of its rows first.
+    template <typename T>
+    std::size_t readRows(
+            std::size_t maxBytes, const RowStorage<T> & storage,
+            std::size_t firstCol = 0,
+            std::size_t lastCol = std::numeric_limits<std::size_t>::max() );
+
+    /// Like the above, but appends the values to @c values.
+    template <typename T>
+    std::size_t readRows(
+            std::size_t maxBytes, std::vector<T> & values,
+            std::size_t firstCol = 0,
+            std::size_t lastCol = std::numeric_limits<std::size_t>::max() )
+    {
+        const auto offset = values.size();
+        std::size_t width = 0;
+        const auto nRows = readRows<T>(
+                    maxBytes, [&]( std::size_t nRows, std::size_t nCols )
+        {
+            width = nCols;
+            values.resize( offset + nRows * nCols );
+            return values.data() + offset;
+        }, firstCol, lastCol );
+        values.resize( offset + nRows * width );
+        return nRows;
+    }
+
+    /// Returns whether the whole file has been read.
+    bool atEnd() const;
+
+    /// Starts reading from the beginning of the file again. The number of
+    /// columns is kept.
+    void rewind();
+
+    /// Returns the number of values in each row. This is zero until the
+    /// first row has been read.
+    std::size_t nCols() const;
+
+    /// Returns the number of rows which have been read so far.
+    std::size_t nRows() const;
+
+    /// Returns the number of lines after the header which have been read
+    /// so far, including blank lines and dropped lines.
+    std::size_t nLines() const;
+
+    /// Returns the positions of the missing values in the columns which
+    /// have been read, in no particular order. They are kept by rewind(),
+    /// so that passes over different columns add up.
+    const std::vector<MissingValue> & missingValues() const;
+
+    /// Returns the lines which have been replaced or dropped in a lenient
+    /// mode since the last rewind(), in the order of the file, up to the
+    /// maximum number given to the constructor. Each pass over the file
+    /// finds all of them.
+    const std::vector<ParseError> & parseErrors() const;
+
+    /// Returns the number of lines which have been replaced or dropped
+    /// since the last rewind(), including those which are not kept.
+    std::size_t nParseErrors() const;
+
+private:
+    // Keeps the errors up to the maximum number and counts all of them.
+    void addParseErrors( const std::vector<ParseError> & newErrors,
+                         std::size_t firstLine );
+
+    // Like readRows() for a file with fixed-width fields.
+    template <typename T>
+    std::size_t readFixedWidthBlock(
+            std::size_t maxBytes, const RowStorage<T> & storage,
+            std::size_t firstCol, std::size_t lastCol );
+
+    const MappedFile & file;
+    FileHeader header;
+    FixedWidthLayout layout;
+    MissingValueRules missingValueRules;
+    BadLines badLines;
+    std::vector<MissingValue> missing;
+    std::size_t maxParseErrors;
+    std::vector<ParseError> errors;
+    std::size_t nErrors = 0;
+    const char * pos;
+    std::size_t nLinesRead = 0;
+    std::size_t nRowsRead = 0;
+    std::size_t cols = 0;
+};
+
+} // namespace conv
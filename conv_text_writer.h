@@ -0,0 +1,260 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_formatting.h"
+#include "conv_matrix_view.h"
+#include "conv_matrix_writer.h"
+#include "conv_parallel.h"
+#include "conv_trace.h"
+
+#include "cpp_utils/exception.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace conv
+{
+
+/// Whether the last value of a line is followed by a space like the
+/// other values.
+enum class TrailingSpace
+{
+    Yes,
+    No,
+};
+
+
+namespace detail
+{
+
+// Number of characters which are collected before they are written to
+// an output file.
+const std::size_t textBufferSize = 1 << 16;
+
+inline void throwWriteError( std::size_t rowNumber,
+                             const std::string & fileName )
+{
+    CU_THROW( "Failed to write row " + std::to_string(rowNumber) +
+              " to the file '" + fileName + "'." );
+}
+
+
+template <FloatNotation notation, typename T, bool isTransposed>
+void appendRow( std::string & out,
+                const StridedView<T, isTransposed> & matrix, std::size_t i,
+                TrailingSpace trailingSpace )
+{
+    for ( std::size_t j = 0; j < matrix.nCols(); ++j )
+    {
+        appendNumber<notation>( out, matrix(i,j) );
+        out += ' ';
+    }
+    if ( trailingSpace == TrailingSpace::No && matrix.nCols() > 0 )
+        out.back() = '\n';
+    else
+        out += '\n';
+}
+
+} // namespace detail
+
+
+/// Appends each row of the matrix as a line of text to an open file.
+///
+/// Each value is followed by a space, except for the last one of a line if
+/// @c trailingSpace is TrailingSpace::No. Blocks of rows are formatted in
+/// parallel and written in order. @c firstRowNumber is the number of the
+/// first row in the whole file, which is used for error messages.
+/// Floating point numbers are written in the given notation.
+template <FloatNotation notation = FloatNotation::Decimal,
+          typename T, bool isTransposed>
+void appendText( const StridedView<T, isTransposed> & matrix,
+                 std::ostream & file, const std::string & fileName,
+                 std::size_t firstRowNumber = 1,
+                 TrailingSpace trailingSpace = TrailingSpace::Yes )
+{
+    // Estimate the number of rows which fill the text buffer.
+    const auto rowsPerBlock = std::max<std::size_t>(
+                detail::textBufferSize / ( 12 * matrix.nCols() + 1 ), 1 );
+    const auto nBlocksPerRound = 4 * ThreadPool::instance().nThreads();
+    const auto rowsPerRound = rowsPerBlock * nBlocksPerRound;
+    std::vector<std::string> texts( nBlocksPerRound );
+    for ( std::size_t roundStart = 0; roundStart < matrix.nRows();
+          roundStart += rowsPerRound )
+    {
+        const auto roundEnd =
+                std::min( roundStart + rowsPerRound, matrix.nRows() );
+        const auto nBlocks =
+                ( roundEnd - roundStart + rowsPerBlock - 1 ) / rowsPerBlock;
+        parallelFor( 0, nBlocks, [&]( std::size_t k )
+        {
+            const auto first = roundStart + k*rowsPerBlock;
+            const TraceScope trace( "format text", first / rowsPerBlock );
+            const auto last = std::min( first + rowsPerBlock, roundEnd );
+            auto & text = texts[k];
+            text.clear();
+            for ( auto i = first; i != last; ++i )
+                detail::appendRow<notation>( text, matrix, i,
+                                             trailingSpace );
+        } );
+        const TraceScope trace( "write text", roundStart / rowsPerRound );
+        for ( std::size_t k = 0; k < nBlocks; ++k )
+        {
+            file.write( texts[k].data(), texts[k].size() );
+            if ( !file.good() )
+                detail::throwWriteError( firstRowNumber - 1 + std::min(
+                    roundStart + (k+1)*rowsPerBlock, roundEnd ), fileName );
+        }
+    }
+}
+
+
+/// Writes each row of the matrix as a line of text to a file.
+///
+/// See appendText() for the format.
+template <FloatNotation notation = FloatNotation::Decimal,
+          typename T, bool isTransposed>
+void writeText( const StridedView<T, isTransposed> & matrix,
+                const std::string & fileName )
+{
+    std::ofstream file( fileName );
+    if ( !file.good() )
+        detail::throwWriteError( 1, fileName );
+    appendText<notation>( matrix, file, fileName );
+    file.flush();
+    if ( !file.good() )
+        detail::throwWriteError( matrix.nRows(), fileName );
+}
+
+
+/// Writes blocks of rows as lines of text to a file. See appendText().
+///
+/// If names of the columns are given, then they are written to the first
+/// line like the values of a row.
+template <typename T, FloatNotation notation = FloatNotation::Decimal>
+class TextMatrixWriter : public MatrixWriter<T>
+{
+public:
+    explicit TextMatrixWriter(
+            const std::string & fileName,
+            const std::vector<std::string> & columnNames = {} )
+        : fileName( fileName )
+        , file( fileName )
+    {
+        if ( !columnNames.empty() )
+        {
+            std::string line;
+            for ( const auto & name : columnNames )
+                line += name + ' ';
+            line += '\n';
+            file.write( line.data(), line.size() );
+        }
+        if ( !file.good() )
+            detail::throwWriteError( 1, fileName );
+    }
+
+    void append( const StridedView<T> & rows ) override
+    {
+        appendText<notation>( rows, file, fileName, nWrittenRows + 1 );
+        nWrittenRows += rows.nRows();
+    }
+
+    void finish() override
+    {
+        file.flush();
+        if ( !file.good() )
+            detail::throwWriteError( nWrittenRows, fileName );
+    }
+
+private:
+    std::string fileName;
+    std::ofstream file;
+    std::size_t nWrittenRows = 0;
+};
+
+
+/// Writes each row of the matrix as a line of text to a file of its own.
+///
+/// The name of the file for a row is determined by @c fileNameOfRow(i)
+/// where @c i is the one-based row number. The files are written in
+/// parallel, so slowly created files do not hold up the others.
+///
+/// If the elements of a row are not contiguous in memory, e.g. for the
+/// transposed view of a matrix, then the rows are written in batches:
+/// The values of adjacent rows which share a cache line are formatted
+/// together, so that each cache line of the matrix is loaded only once
+/// and no transposed copy is needed.
+template <FloatNotation notation = FloatNotation::Decimal,
+          typename T, bool isTransposed, typename F>
+void writeTextPerRow( const StridedView<T, isTransposed> & matrix,
+                      F && fileNameOfRow )
+{
+    const std::size_t batchSize =
+            StridedView<T, isTransposed>::hasContiguousRows
+            ? 1
+            : ( sizeof(T) < 64 ? 64 / sizeof(T) : 1 );
+    const auto nBatches = ( matrix.nRows() + batchSize - 1 ) / batchSize;
+    const auto writeBatch = [&]( std::size_t batch )
+    {
+        const TraceScope trace( "write row files", batch );
+        const auto first = batch * batchSize;
+        const auto last = std::min( first + batchSize, matrix.nRows() );
+        std::vector<std::string> fileNames;
+        std::vector<std::unique_ptr<std::ofstream>> files;
+        for ( auto i = first; i < last; ++i )
+        {
+            fileNames.push_back( fileNameOfRow( i+1 ) );
+            files.push_back( std::unique_ptr<std::ofstream>(
+                                 new std::ofstream( fileNames.back() ) ) );
+        }
+        const auto flush = [&]( std::vector<std::string> & buffers )
+        {
+            for ( auto i = first; i < last; ++i )
+            {
+                auto & file = *files[i-first];
+                auto & buffer = buffers[i-first];
+                file.write( buffer.data(), buffer.size() );
+                buffer.clear();
+                if ( !file.good() )
+                    detail::throwWriteError( i+1, fileNames[i-first] );
+            }
+        };
+
+        std::vector<std::string> buffers( last - first );
+        for ( std::size_t j = 0; j < matrix.nCols(); ++j )
+        {
+            for ( auto i = first; i < last; ++i )
+            {
+                auto & buffer = buffers[i-first];
+                appendNumber<notation>( buffer, matrix(i,j) );
+                buffer += ' ';
+            }
+            if ( buffers.front().size() >= detail::textBufferSize )
+                flush( buffers );
+        }
+        for ( auto & buffer : buffers )
+            buffer += '\n';
+        flush( buffers );
+        for ( auto i = first; i < last; ++i )
+        {
+            files[i-first]->flush();
+            if ( !files[i-first]->good() )
+                detail::throwWriteError( i+1, fileNames[i-first] );
+        }
+    };
+    // Contiguous rows are written by the NUMA node which holds them.
+    if ( StridedView<T, isTransposed>::hasContiguousRows )
+        parallelForOnNodes( 0, nBatches, writeBatch );
+    else
+        parallelFor( 0, nBatches, writeBatch );
+}
+
+} // namespace conv
@@ -0,0 +1,400 @@
+#include "conv_thread_pool.h"
+
+#include "conv_numa.h"
+
+#include "cpp_utils/std_make_unique.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace conv
+{
+
+struct ThreadPool::Impl
+{
+    using Task = std::function<void()>;
+
+    struct Worker
+    {
+        std::size_t node = 0;
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct Node
+    {
+        std::vector<int> cpus;
+        std::vector<std::size_t> workers;
+        // Tasks which must only be run by the workers of this node.
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<std::size_t> nQueuedTasks{ 0 };
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<std::thread> threads;
+    // Number of tasks in the deques of the workers together.
+    std::atomic<std::size_t> nQueuedTasks{ 0 };
+    // Next worker which gets a task submitted from outside the pool.
+    std::atomic<std::size_t> nextWorker{ 0 };
+    std::atomic<bool> shallPinThreads{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool isStopping = false;
+
+    // The pool and the index of the worker running in the current thread.
+    static thread_local Impl * currentPool;
+    static thread_local std::size_t currentWorker;
+
+    static bool tryPopFront( std::mutex & mutex, std::deque<Task> & tasks,
+                             std::atomic<std::size_t> & nQueued, Task & task )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( tasks.empty() )
+            return false;
+        task = std::move( tasks.front() );
+        tasks.pop_front();
+        --nQueued;
+        return true;
+    }
+
+    bool tryPopOwn( std::size_t i, Task & task )
+    {
+        auto & worker = *workers[i];
+        std::lock_guard<std::mutex> lock( worker.mutex );
+        if ( worker.tasks.empty() )
+            return false;
+        task = std::move( worker.tasks.back() );
+        worker.tasks.pop_back();
+        --nQueuedTasks;
+        return true;
+    }
+
+    // Steals from the workers of the same node first.
+    bool trySteal( std::size_t thief, Task & task )
+    {
+        const auto node = workers[thief]->node;
+        for ( const bool isSameNode : { true, false } )
+        {
+            for ( std::size_t k = 1; k <= workers.size(); ++k )
+            {
+                auto & victim = *workers[(thief + k) % workers.size()];
+                if ( ( victim.node == node ) == isSameNode &&
+                     tryPopFront( victim.mutex, victim.tasks,
+                                  nQueuedTasks, task ) )
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool tryTake( Task & task )
+    {
+        if ( currentPool != this )
+            return trySteal( 0, task );
+        auto & node = *nodes[workers[currentWorker]->node];
+        return tryPopOwn( currentWorker, task ) ||
+               tryPopFront( node.mutex, node.tasks, node.nQueuedTasks,
+                            task ) ||
+               trySteal( currentWorker, task );
+    }
+
+    void wakeUpWorkers( bool all )
+    {
+        // Taking the lock makes sure that no worker is between checking
+        // for tasks and going to sleep.
+        {
+            std::lock_guard<std::mutex> lock( sleepMutex );
+        }
+        if ( all )
+            wakeUp.notify_all();
+        else
+            wakeUp.notify_one();
+    }
+
+    void runWorker( std::size_t i )
+    {
+        currentPool = this;
+        currentWorker = i;
+        auto & node = *nodes[workers[i]->node];
+        const auto allCpus = [this]
+        {
+            std::vector<int> cpus;
+            for ( const auto & node : nodes )
+                cpus.insert( end(cpus), begin(node->cpus), end(node->cpus) );
+            return cpus;
+        }();
+        bool isPinned = false;
+        for (;;)
+        {
+            if ( shallPinThreads != isPinned )
+            {
+                isPinned = shallPinThreads;
+                if ( !node.cpus.empty() )
+                    pinCurrentThread( isPinned ? node.cpus : allCpus );
+            }
+            Task task;
+            if ( tryTake( task ) )
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock( sleepMutex );
+            wakeUp.wait( lock, [&]
+            {
+                return nQueuedTasks != 0 || node.nQueuedTasks != 0 ||
+                       isStopping;
+            } );
+            if ( isStopping && nQueuedTasks == 0 && node.nQueuedTasks == 0 )
+                return;
+        }
+    }
+};
+
+thread_local ThreadPool::Impl * ThreadPool::Impl::currentPool = nullptr;
+thread_local std::size_t ThreadPool::Impl::currentWorker = 0;
+
+
+ThreadPool::ThreadPool( std::size_t nThreads )
+    : ThreadPool( [nThreads]
+    {
+        // one node with unknown CPUs
+        NumaTopology topology;
+        topology.cpusOfNodes.push_back(
+                    std::vector<int>( std::max<std::size_t>( nThreads, 1 ),
+                                      -1 ) );
+        return topology;
+    }() )
+{
+}
+
+
+ThreadPool::ThreadPool( const NumaTopology & topology )
+{
+    m = std::make_unique<Impl>();
+    for ( const auto & cpus : topology.cpusOfNodes )
+    {
+        m->nodes.push_back( std::make_unique<Impl::Node>() );
+        auto & node = *m->nodes.back();
+        for ( const auto cpu : cpus )
+        {
+            if ( cpu >= 0 )
+                node.cpus.push_back( cpu );
+            node.workers.push_back( m->workers.size() );
+            m->workers.push_back( std::make_unique<Impl::Worker>() );
+            m->workers.back()->node = m->nodes.size() - 1;
+        }
+    }
+    for ( std::size_t i = 0; i < m->workers.size(); ++i )
+        m->threads.emplace_back( [this, i] { m->runWorker( i ); } );
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( m->sleepMutex );
+        m->isStopping = true;
+    }
+    m->wakeUp.notify_all();
+    for ( auto & thread : m->threads )
+        thread.join();
+}
+
+
+ThreadPool & ThreadPool::instance()
+{
+    static ThreadPool pool( detectNumaTopology() );
+    return pool;
+}
+
+
+std::size_t ThreadPool::nThreads() const
+{
+    return m->workers.size();
+}
+
+
+std::size_t ThreadPool::nNodes() const
+{
+    return m->nodes.size();
+}
+
+
+void ThreadPool::setThreadPinning( bool shallPin )
+{
+    m->shallPinThreads = shallPin;
+}
+
+
+void ThreadPool::submit( std::function<void()> task )
+{
+    const auto i = Impl::currentPool == m.get()
+            ? Impl::currentWorker
+            : m->nextWorker++ % m->workers.size();
+    {
+        auto & worker = *m->workers[i];
+        std::lock_guard<std::mutex> lock( worker.mutex );
+        worker.tasks.push_back( std::move(task) );
+        ++m->nQueuedTasks;
+    }
+    m->wakeUpWorkers( false );
+}
+
+
+void ThreadPool::submitToNode( std::size_t node,
+                               std::function<void()> task )
+{
+    auto & n = *m->nodes.at( node );
+    {
+        std::lock_guard<std::mutex> lock( n.mutex );
+        n.tasks.push_back( std::move(task) );
+        ++n.nQueuedTasks;
+    }
+    // Only some of the workers may take the task.
+    m->wakeUpWorkers( true );
+}
+
+
+std::size_t ThreadPool::currentNode() const
+{
+    if ( Impl::currentPool != m.get() )
+        return m->nodes.size();
+    return m->workers[Impl::currentWorker]->node;
+}
+
+
+struct TaskGroup::State
+{
+    using Task = std::function<void()>;
+
+    std::mutex mutex;
+    // Signals that a task has been queued or that all have finished.
+    std::condition_variable changed;
+    // Tasks which have not been started yet. The tasks bound to a node
+    // are queued separately for each node.
+    std::deque<Task> tasks;
+    std::vector<std::deque<Task>> nodeTasks;
+    // Number of queued and running tasks.
+    std::size_t nPendingTasks = 0;
+    std::exception_ptr firstException;
+
+    void enqueue( std::deque<Task> & queue, Task task )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        queue.push_back( std::move(task) );
+        ++nPendingTasks;
+        changed.notify_all();
+    }
+
+    void execute( Task & task )
+    {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if ( !firstException )
+                firstException = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( --nPendingTasks == 0 )
+            changed.notify_all();
+    }
+
+    // Runs the oldest task of the queue, unless the waiting thread has
+    // taken all of them.
+    void runOldest( std::deque<Task> & queue )
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if ( queue.empty() )
+                return;
+            task = std::move( queue.front() );
+            queue.pop_front();
+        }
+        execute( task );
+    }
+};
+
+
+TaskGroup::TaskGroup( ThreadPool & pool )
+    : pool( pool )
+    , state( std::make_shared<State>() )
+{
+    state->nodeTasks.resize( pool.nNodes() );
+}
+
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {
+    }
+}
+
+
+void TaskGroup::run( std::function<void()> task )
+{
+    state->enqueue( state->tasks, std::move(task) );
+    const auto s = state;
+    pool.submit( [s] { s->runOldest( s->tasks ); } );
+}
+
+
+void TaskGroup::runOnNode( std::size_t node, std::function<void()> task )
+{
+    state->enqueue( state->nodeTasks.at( node ), std::move(task) );
+    const auto s = state;
+    pool.submitToNode( node, [s, node]
+    {
+        s->runOldest( s->nodeTasks[node] );
+    } );
+}
+
+
+void TaskGroup::wait()
+{
+    const auto node = pool.currentNode();
+    std::unique_lock<std::mutex> lock( state->mutex );
+    while ( state->nPendingTasks != 0 )
+    {
+        // The newest task is taken, so recursively split work is
+        // processed depth first, while the pool runs the oldest ones.
+        auto & queue = !state->tasks.empty() || node >= pool.nNodes()
+                ? state->tasks
+                : state->nodeTasks[node];
+        if ( queue.empty() )
+        {
+            state->changed.wait( lock );
+            continue;
+        }
+        auto task = std::move( queue.back() );
+        queue.pop_back();
+        lock.unlock();
+        state->execute( task );
+        lock.lock();
+    }
+    if ( state->firstException )
+    {
+        auto e = state->firstException;
+        state->firstException = nullptr;
+        std::rethrow_exception( e );
+    }
+}
+
+} // namespace conv
@@ -0,0 +1,111 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace conv
+{
+
+struct NumaTopology;
+
+/// Pool of worker threads which balance their load by stealing tasks
+/// from each other.
+///
+/// Each worker owns a deque of tasks. Tasks submitted by a worker are
+/// pushed to the back of its own deque and the worker takes its next task
+/// from there as well, so recursively split work is processed depth
+/// first. A worker without tasks steals from the front of the deques of
+/// the other workers, where the oldest and usually biggest tasks are.
+/// Tasks submitted from other threads are distributed round-robin.
+///
+/// The workers are grouped by NUMA node. Thieves prefer victims on their
+/// own node, and tasks can be bound to a node, e.g. in order to place
+/// memory on that node by touching it first.
+class ThreadPool
+{
+public:
+    /// Starts @c nThreads worker threads on a single node.
+    explicit ThreadPool( std::size_t nThreads );
+    /// Starts one worker thread per CPU of the topology.
+    explicit ThreadPool( const NumaTopology & topology );
+    /// Waits for the queued tasks to finish and stops the workers.
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool & ) = delete;
+    ThreadPool & operator=( const ThreadPool & ) = delete;
+
+    /// Returns the pool which is shared by the whole program.
+    ///
+    /// It has a worker for each CPU the process may run on.
+    static ThreadPool & instance();
+
+    std::size_t nThreads() const;
+    std::size_t nNodes() const;
+
+    /// Sets whether the workers are restricted to the CPUs of their node.
+    ///
+    /// The workers apply the setting before they start their next task.
+    void setThreadPinning( bool shallPin );
+
+    /// Enqueues a task. Tasks must not throw.
+    void submit( std::function<void()> task );
+
+    /// Enqueues a task which is only run by the workers of the node.
+    void submitToNode( std::size_t node, std::function<void()> task );
+
+    /// Returns the node of the worker which runs the calling thread or
+    /// nNodes(), if the calling thread is not a worker of this pool.
+    std::size_t currentNode() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m;
+};
+
+
+/// Set of tasks which are run by a thread pool and can be waited for.
+///
+/// The tasks are kept in queues of the group. For each task the pool only
+/// gets a small job which runs the next task of the group, if there is
+/// one left. A thread which waits for the group takes tasks from the same
+/// queues. Thus it helps with the work it is waiting for, but never runs
+/// a task of another group, which might take much longer.
+class TaskGroup
+{
+public:
+    explicit TaskGroup( ThreadPool & pool = ThreadPool::instance() );
+    /// Waits for the tasks of the group. Exceptions are dropped.
+    ~TaskGroup();
+
+    TaskGroup( const TaskGroup & ) = delete;
+    TaskGroup & operator=( const TaskGroup & ) = delete;
+
+    /// Runs the task in the thread pool.
+    void run( std::function<void()> task );
+
+    /// Runs the task on a worker of the given node.
+    void runOnNode( std::size_t node, std::function<void()> task );
+
+    /// Waits until all tasks of the group have finished and runs tasks
+    /// of the group meanwhile, which have not been started yet. Tasks
+    /// bound to a node are only run, if the calling thread is a worker of
+    /// that node. If tasks have thrown, then the first exception is
+    /// rethrown.
+    void wait();
+
+private:
+    struct State;
+
+    ThreadPool & pool;
+    // The jobs in the pool share the state, since they may outlive the
+    // group, if the waiting thread has run their tasks.
+    std::shared_ptr<State> state;
+};
+
+} // namespace conv
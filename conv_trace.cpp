@@ -0,0 +1,160 @@
+#include "conv_trace.h"
+
+#include "cpp_utils/exception.h"
+
+#include <cstdio>
+#include <fstream>
+#include <locale>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace conv
+{
+
+namespace
+{
+
+// Number of events each thread keeps.
+const std::size_t ringBufferSize = 1 << 16;
+
+struct Event
+{
+    const char * name;
+    std::int64_t index;
+    std::int64_t begin;
+    std::int64_t end;
+};
+
+// Events of a single thread. Only the owning thread writes to it.
+struct ThreadEvents
+{
+    explicit ThreadEvents( std::size_t threadId )
+        : threadId( threadId )
+        , events( ringBufferSize )
+    {
+    }
+
+    std::size_t threadId;
+    std::vector<Event> events;
+    // Number of events recorded since tracing has been started.
+    std::atomic<std::uint64_t> nRecorded{ 0 };
+};
+
+// The buffers of all threads which have ever recorded events. They are
+// kept after their threads have finished, so their events can be
+// written.
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadEvents>> threads;
+    std::int64_t startTime = 0;
+};
+
+Registry & registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+ThreadEvents & eventsOfThisThread()
+{
+    // Only the first event of a thread takes the lock.
+    static thread_local ThreadEvents * events = nullptr;
+    if ( !events )
+    {
+        auto & r = registry();
+        std::lock_guard<std::mutex> lock( r.mutex );
+        r.threads.push_back( std::unique_ptr<ThreadEvents>(
+                                 new ThreadEvents( r.threads.size() ) ) );
+        events = r.threads.back().get();
+    }
+    return *events;
+}
+
+} // unnamed namespace
+
+
+namespace detail
+{
+
+std::atomic<bool> isTracing{ false };
+
+
+void recordTraceEvent( const char * name, std::int64_t index,
+                       std::int64_t begin, std::int64_t end )
+{
+    auto & thread = eventsOfThisThread();
+    const auto n = thread.nRecorded.load( std::memory_order_relaxed );
+    thread.events[n % ringBufferSize] = Event{ name, index, begin, end };
+    thread.nRecorded.store( n + 1, std::memory_order_release );
+}
+
+} // namespace detail
+
+
+void startTracing()
+{
+    auto & r = registry();
+    {
+        std::lock_guard<std::mutex> lock( r.mutex );
+        for ( auto & thread : r.threads )
+            thread->nRecorded = 0;
+        r.startTime = detail::traceClock();
+    }
+    detail::isTracing = true;
+}
+
+
+void stopTracing()
+{
+    detail::isTracing = false;
+}
+
+
+void writeTrace( const std::string & fileName )
+{
+    std::ofstream file( fileName );
+    if ( !file )
+        CU_THROW( "Could not open the trace file '" + fileName + "'." );
+    file.imbue( std::locale::classic() );
+    auto & r = registry();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    file << "{\"traceEvents\":[\n";
+    bool isFirst = true;
+    char text[64];
+    for ( const auto & thread : r.threads )
+    {
+        const auto nRecorded =
+                thread->nRecorded.load( std::memory_order_acquire );
+        const auto first = nRecorded > ringBufferSize
+                ? nRecorded - ringBufferSize : 0;
+        for ( auto i = first; i != nRecorded; ++i )
+        {
+            const auto & event = thread->events[i % ringBufferSize];
+            // Chrome expects the times in microseconds. Integers are
+            // formatted, so the decimal point does not depend on the locale.
+            const auto ts = event.begin - r.startTime;
+            const auto dur = event.end - event.begin;
+            std::snprintf( text, sizeof(text),
+                           "%lld.%03lld,\"dur\":%lld.%03lld",
+                           static_cast<long long>( ts / 1000 ),
+                           static_cast<long long>( ts % 1000 ),
+                           static_cast<long long>( dur / 1000 ),
+                           static_cast<long long>( dur % 1000 ) );
+            file << ( isFirst ? "" : ",\n" )
+                 << "{\"name\":\"" << event.name
+                 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->threadId
+                 << ",\"ts\":" << text;
+            if ( event.index >= 0 )
+                file << ",\"args\":{\"index\":" << event.index << "}";
+            file << "}";
+            isFirst = false;
+        }
+    }
+    file << "\n]}\n";
+    if ( !file.good() )
+        CU_THROW( "Failed to write the trace file '" + fileName + "'." );
+}
+
+} // namespace conv
@@ -0,0 +1,86 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace conv
+{
+
+namespace detail
+{
+
+extern std::atomic<bool> isTracing;
+
+inline std::int64_t traceClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void recordTraceEvent( const char * name, std::int64_t index,
+                       std::int64_t begin, std::int64_t end );
+
+} // namespace detail
+
+
+/// Records the time span of its lifetime as an event of the trace, if
+/// tracing is active.
+///
+/// Each thread records its events into a ring buffer of its own without
+/// locking, so tracing hardly disturbs the timing of the traced code. If
+/// a buffer is full, the oldest events of the thread are overwritten.
+/// While tracing is inactive, creating a scope only costs a load of a
+/// flag.
+///
+/// @c name must be a string literal or live until the trace has been
+/// written. @c index identifies e.g. the chunk or block which is
+/// processed. Negative indices are not shown.
+class TraceScope
+{
+public:
+    explicit TraceScope( const char * name, std::int64_t index = -1 )
+        : name( name )
+        , index( index )
+        , begin( detail::isTracing.load( std::memory_order_relaxed )
+                 ? detail::traceClock() : 0 )
+    {
+    }
+
+    ~TraceScope()
+    {
+        if ( begin != 0 )
+            detail::recordTraceEvent( name, index, begin,
+                                      detail::traceClock() );
+    }
+
+    TraceScope( const TraceScope & ) = delete;
+    TraceScope & operator=( const TraceScope & ) = delete;
+
+private:
+    const char * name;
+    std::int64_t index;
+    std::int64_t begin;
+};
+
+
+/// Discards all recorded events and starts recording.
+void startTracing();
+
+/// Stops recording events.
+void stopTracing();
+
+/// Writes the recorded events to a file in the Chrome trace event format,
+/// which can be opened with Perfetto or @c chrome://tracing.
+///
+/// Must not be called while traced code is running. Throws, if the file
+/// cannot be written.
+void writeTrace( const std::string & fileName );
+
+} // namespace conv
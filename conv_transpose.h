@@ -0,0 +1,304 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include "conv_parallel.h"
+#include "conv_trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace conv
+{
+
+namespace detail
+{
+
+// Edge length of the square tiles which are swapped by transposeSquares().
+const std::size_t transposeTileSize = 32;
+
+// Transposes the @c nSquares consecutive square matrices of size @c n x @c n
+// stored at @c data in place. Pairs of tiles are swapped in parallel.
+// Each row of tiles is handled by the NUMA node which holds it.
+template <typename T>
+void transposeSquares( T * data, std::size_t n, std::size_t nSquares )
+{
+    const auto nTiles = ( n + transposeTileSize - 1 ) / transposeTileSize;
+    parallelForOnNodes( 0, nSquares * nTiles, [=]( std::size_t k )
+    {
+        const TraceScope trace( "swap tiles", k );
+        const auto square = data + (k / nTiles) * n * n;
+        const auto rowFirst = (k % nTiles) * transposeTileSize;
+        const auto rowLast = std::min( rowFirst + transposeTileSize, n );
+        // Swap the tiles right of the diagonal with their mirror images
+        // below the diagonal.
+        for ( auto colFirst = rowFirst; colFirst < n;
+              colFirst += transposeTileSize )
+        {
+            const auto colLast = std::min( colFirst + transposeTileSize, n );
+            for ( auto r = rowFirst; r < rowLast; ++r )
+                for ( auto c = std::max( colFirst, r+1 ); c < colLast; ++c )
+                    std::swap( square[r*n+c], square[c*n+r] );
+        }
+    } );
+}
+
+
+// Number of elements of a unit which are moved by the same task of
+// permuteUnits(). Long units are split, so that a few long cycles are
+// still moved in parallel.
+const std::size_t permuteStripSize = 4096;
+
+// Number of cycles which are moved by the same task of permuteUnits().
+const std::size_t permuteCyclesPerTask = 256;
+
+// Moves the unit at position @c source(p) to position @c p for each of the
+// @c nUnits units stored at @c data, where a unit consists of @c unitSize
+// consecutive elements. @c source must be a permutation.
+//
+// The permutation is decomposed into its cycles. The cycles are found
+// first by a single walk over all positions, which marks the visited ones
+// in a bit set, so each cycle is walked only once. Then the cycles are
+// moved in parallel. They are independent of each other, as are strips
+// of the units at different offsets.
+template <typename T, typename Source>
+void permuteUnits( T * data, std::size_t nUnits, std::size_t unitSize,
+                   Source source )
+{
+    std::vector<std::size_t> leaders;
+    {
+        const TraceScope trace( "find cycles" );
+        std::vector<bool> isVisited( nUnits );
+        for ( std::size_t start = 0; start != nUnits; ++start )
+        {
+            if ( isVisited[start] )
+                continue;
+            isVisited[start] = true;
+            if ( source(start) == start )
+                continue;
+            leaders.push_back( start );
+            for ( auto p = source(start); p != start; p = source(p) )
+                isVisited[p] = true;
+        }
+    }
+
+    const auto nStrips = ( unitSize + permuteStripSize - 1 ) /
+            permuteStripSize;
+    const auto nCycleBlocks = ( leaders.size() + permuteCyclesPerTask - 1 ) /
+            permuteCyclesPerTask;
+    parallelFor( 0, nCycleBlocks * nStrips, [&]( std::size_t k )
+    {
+        const TraceScope trace( "move cycles", k );
+        const auto stripFirst = (k % nStrips) * permuteStripSize;
+        const auto stripSize =
+                std::min( stripFirst + permuteStripSize, unitSize ) -
+                stripFirst;
+        const auto strip = data + stripFirst;
+        std::vector<T> buffer( stripSize );
+        const auto first = begin(leaders) +
+                (k / nStrips) * permuteCyclesPerTask;
+        const auto last = first + std::min<std::size_t>(
+                    end(leaders) - first, permuteCyclesPerTask );
+        for ( auto leader = first; leader != last; ++leader )
+        {
+            const auto start = *leader;
+            std::copy_n( strip + start*unitSize, stripSize, buffer.data() );
+            auto p = start;
+            for ( auto q = source(p); q != start; p = q, q = source(q) )
+                std::copy_n( strip + q*unitSize, stripSize,
+                             strip + p*unitSize );
+            std::copy_n( buffer.data(), stripSize, strip + p*unitSize );
+        }
+    } );
+}
+
+
+// Transposes the @c nRows x @c nCols matrix of units stored at @c data in
+// place, where a unit consists of @c unitSize consecutive elements.
+template <typename T>
+void transposeUnits( T * data, std::size_t nRows, std::size_t nCols,
+                     std::size_t unitSize )
+{
+    // Position in the transposed matrix from which the unit at the
+    // position p of the result has to be taken.
+    permuteUnits( data, nRows * nCols, unitSize, [=]( std::size_t p )
+    {
+        return (p % nRows) * nCols + p / nRows;
+    } );
+}
+
+
+// Number of neighbouring columns which are rotated by the same task of
+// rotateColumns().
+const std::size_t rotatePanelWidth = 64;
+
+// Moves the value in row @c (i+shift(j))%nRows of column @c j to row @c i
+// for each column @c j of the @c nRows x @c nCols matrix at @c data.
+//
+// Each column is rotated in place by reversing both parts and then the
+// whole column. The columns of a panel are reversed in lockstep, so each
+// step touches short pieces of a few neighbouring rows, if the shifts of
+// neighbouring columns are close to each other.
+template <typename T, typename Shift>
+void rotateColumns( T * data, std::size_t nRows, std::size_t nCols,
+                    Shift shift )
+{
+    const auto nPanels = ( nCols + rotatePanelWidth - 1 ) / rotatePanelWidth;
+    parallelFor( 0, nPanels, [&]( std::size_t panel )
+    {
+        const TraceScope trace( "rotate columns", panel );
+        const auto first = panel * rotatePanelWidth;
+        const auto last = std::min( first + rotatePanelWidth, nCols );
+        std::vector<std::size_t> shifts;
+        for ( auto j = first; j != last; ++j )
+            shifts.push_back( shift(j) % nRows );
+        const std::vector<std::size_t> tops( last - first, 0 );
+        const std::vector<std::size_t> bottoms( last - first, nRows );
+        // Reverses the rows [lo[j-first],hi[j-first]) of each column j.
+        const auto reverse = [&]( const std::vector<std::size_t> & lo,
+                                  const std::vector<std::size_t> & hi )
+        {
+            for ( std::size_t t = 0; 2*t + 1 < nRows; ++t )
+                for ( auto j = first; j != last; ++j )
+                {
+                    const auto lower = lo[j-first];
+                    const auto upper = hi[j-first];
+                    if ( 2*t + 1 < upper - lower )
+                        std::swap( data[(lower+t)*nCols+j],
+                                   data[(upper-1-t)*nCols+j] );
+                }
+        };
+        reverse( tops, shifts );
+        reverse( shifts, bottoms );
+        reverse( tops, bottoms );
+    } );
+}
+
+
+// Moves the value in column j of row i to column
+// ((i + j/b) % nRows + j*nRows) % nCols of the same row for each row i.
+// This is the step of transposeGeneral() which works on rows.
+template <typename T>
+void shuffleRows( T * data, std::size_t nRows, std::size_t nCols,
+                  std::size_t b )
+{
+    const auto rowsPerTask =
+            std::max<std::size_t>( permuteStripSize / nCols, 1 );
+    const auto nTasks = ( nRows + rowsPerTask - 1 ) / rowsPerTask;
+    const auto step = nRows % nCols;
+    parallelForOnNodes( 0, nTasks, [&]( std::size_t k )
+    {
+        const TraceScope trace( "shuffle rows", k );
+        std::vector<T> buffer( nCols );
+        const auto first = k * rowsPerTask;
+        const auto last = std::min( first + rowsPerTask, nRows );
+        for ( auto i = first; i != last; ++i )
+        {
+            const auto row = data + i*nCols;
+            // j*nRows % nCols and (i + j/b) % nRows % nCols are updated
+            // incrementally, which avoids a division for each value.
+            std::size_t offset = 0;
+            std::size_t base = 0;
+            for ( std::size_t j = 0; j != nCols; ++j )
+            {
+                if ( j % b == 0 )
+                    base = ( i + j/b ) % nRows % nCols;
+                auto col = base + offset;
+                if ( col >= nCols )
+                    col -= nCols;
+                buffer[col] = row[j];
+                offset += step;
+                if ( offset >= nCols )
+                    offset -= nCols;
+            }
+            std::copy( begin(buffer), end(buffer), row );
+        }
+    } );
+}
+
+
+// Greatest common divisor.
+inline std::size_t gcd( std::size_t a, std::size_t b )
+{
+    while ( b != 0 )
+    {
+        a %= b;
+        std::swap( a, b );
+    }
+    return a;
+}
+
+
+// Transposes the @c nRows x @c nCols matrix at @c data in place for any
+// shape, e.g. if the dimensions are coprime.
+//
+// This follows "A Decomposition for In-place Matrix Transposition" by
+// Catanzaro, Keller and Garland. The transposition is split into
+// rotations of the columns, a permutation of the values within each row
+// and a permutation of whole rows. Each of these steps moves long
+// contiguous pieces or values in the same few rows and runs in parallel.
+// Apart from a buffer for a row per task, no memory is needed.
+template <typename T>
+void transposeGeneral( T * data, std::size_t nRows, std::size_t nCols )
+{
+    const auto c = gcd( nRows, nCols );
+    const auto a = nRows / c;
+    const auto b = nCols / c;
+    if ( c > 1 )
+        rotateColumns( data, nRows, nCols,
+                       [b]( std::size_t j ) { return j / b; } );
+    shuffleRows( data, nRows, nCols, b );
+    rotateColumns( data, nRows, nCols,
+                   []( std::size_t j ) { return j; } );
+    permuteUnits( data, nRows, nCols, [=]( std::size_t i )
+    {
+        return ( i * nCols - i / a ) % nRows;
+    } );
+}
+
+} // namespace detail
+
+
+/// Transposes the row-major @c nRows x @c nCols matrix stored at @c data
+/// in place without allocating a second matrix.
+///
+/// Square matrices are transposed by swapping tiles. If one of the
+/// dimensions is a multiple of the other, then the matrix is treated as a
+/// sequence of squares, which are transposed by swapping tiles and moved
+/// by following the cycles of the permutation of their rows. Other shapes
+/// are transposed by rotating columns and permuting the values within the
+/// rows and the rows as a whole. Thus values are always moved in pieces
+/// or in small regions of the matrix, never one by one across the whole
+/// matrix.
+template <typename T>
+void transposeInPlace( T * data, std::size_t nRows, std::size_t nCols )
+{
+    if ( nRows <= 1 || nCols <= 1 )
+        return; // the memory layout does not change
+    if ( nRows % nCols == 0 )
+    {
+        // The matrix is a column of squares. Transpose each of them and
+        // then interleave their rows.
+        const auto nSquares = nRows / nCols;
+        detail::transposeSquares( data, nCols, nSquares );
+        if ( nSquares > 1 )
+            detail::transposeUnits( data, nSquares, nCols, nCols );
+    }
+    else if ( nCols % nRows == 0 )
+    {
+        // The matrix is a row of squares. Separate them from each other
+        // and transpose each of them.
+        const auto nSquares = nCols / nRows;
+        detail::transposeUnits( data, nRows, nSquares, nRows );
+        detail::transposeSquares( data, nRows, nSquares );
+    }
+    else
+        detail::transposeGeneral( data, nRows, nCols );
+}
+
+} // namespace conv
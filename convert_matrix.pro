@@ -9,10 +9,68 @@ DEPENDPATH += . ../cpp_utils/ ../qt_utils/
 INCLUDEPATH += ..
 
 HEADERS  += \
+	conv_arrow_writer.h \
+	conv_buffer.h \
+	conv_chunk_file_writer.h \
+	conv_chunked_writer.h \
+	conv_column_major_writer.h \
+	conv_columnar_writer.h \
+	conv_conversion.h \
+	conv_dense_matrix.h \
+	conv_encoding.h \
+	conv_fixed_width.h \
+	conv_flat_buffer.h \
+	conv_formatting.h \
+	conv_header.h \
+	conv_line_index.h \
+	conv_mapped_file.h \
+	conv_matrix_view.h \
+	conv_matrix_writer.h \
+	conv_memory_plan.h \
+	conv_min_max_pyramid.h \
+	conv_missing_values.h \
+	conv_numa.h \
+	conv_parallel.h \
+	conv_parse_errors.h \
+	conv_parsing.h \
+	conv_perf_counters.h \
+	conv_quantized_writer.h \
+	conv_row_reader.h \
+	conv_text_writer.h \
+	conv_thread_pool.h \
+	conv_trace.h \
+	conv_transpose.h \
+	gui_heatmap_widget.h \
 	gui_main_window.h \
+	gui_matrix_preview_model.h \
 
 SOURCES += main.cpp\
+	conv_arrow_writer.cpp \
+	conv_buffer.cpp \
+	conv_chunk_file_writer.cpp \
+	conv_column_major_writer.cpp \
+	conv_conversion.cpp \
+	conv_encoding.cpp \
+	conv_fixed_width.cpp \
+	conv_flat_buffer.cpp \
+	conv_formatting.cpp \
+	conv_header.cpp \
+	conv_line_index.cpp \
+	conv_mapped_file.cpp \
+	conv_memory_plan.cpp \
+	conv_min_max_pyramid.cpp \
+	conv_missing_values.cpp \
+	conv_numa.cpp \
+	conv_parse_errors.cpp \
+	conv_parsing.cpp \
+	conv_perf_counters.cpp \
+	conv_quantized_writer.cpp \
+	conv_row_reader.cpp \
+	conv_thread_pool.cpp \
+	conv_trace.cpp \
+	gui_heatmap_widget.cpp \
 	gui_main_window.cpp \
+	gui_matrix_preview_model.cpp \
 
 FORMS    += \
 	gui_main_window.ui
@@ -22,3 +80,10 @@ LIBS += \
 #	-L/usr/lib/ -lopencv_core -lopencv_imgproc -lopencv_highgui \
 	-L../cpp_utils -lcpp_utils \
 
+# Build with "qmake CONFIG+=numa" to detect the NUMA topology with libnuma
+# instead of sysfs.
+numa {
+	DEFINES += CONVERT_MATRIX_USE_LIBNUMA
+	LIBS += -lnuma
+}
+
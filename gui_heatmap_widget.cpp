@@ -0,0 +1,198 @@
+#include "gui_heatmap_widget.h"
+
+#include "conv_min_max_pyramid.h"
+#include "cpp_utils/std_make_unique.h"
+
+#include <QImage>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace gui
+{
+
+namespace
+{
+
+QRgb colorOf( float value, float min, float max )
+{
+    const auto t = max > min
+            ? std::min( std::max( ( value - min ) / ( max - min ), 0.f ), 1.f )
+            : 0.5f;
+    // from blue (low) to red (high)
+    return QColor::fromHsvF( ( 1. - t ) * 2. / 3., 1., 1. ).rgb();
+}
+
+
+QImage createImage( const conv::MinMaxGrid & grid, float min, float max )
+{
+    QImage image( static_cast<int>( grid.width ),
+                  static_cast<int>( grid.height ),
+                  QImage::Format_ARGB32 );
+    for ( std::size_t y = 0; y < grid.height; ++y )
+    {
+        const auto line = reinterpret_cast<QRgb *>(
+                    image.scanLine( static_cast<int>( y ) ) );
+        for ( std::size_t x = 0; x < grid.width; ++x )
+            line[x] = grid.isEmpty( x, y )
+                    ? qRgba( 0, 0, 0, 0 )
+                    : colorOf( grid.maxs[y*grid.width+x], min, max );
+    }
+    return image;
+}
+
+} // unnamed namespace
+
+
+struct HeatmapWidget::Impl
+{
+    std::shared_ptr<const conv::MinMaxPyramid> pyramid;
+    // Images of the pyramid levels. They are created on demand.
+    std::vector<QImage> images;
+    // Zoom factor. 1 shows the whole matrix.
+    double zoom = 1.;
+    // Center of the visible area in coordinates where the whole matrix
+    // is the unit square.
+    QPointF center = QPointF( 0.5, 0.5 );
+    QPoint lastMousePos;
+
+    void clampCenter()
+    {
+        const auto halfSize = 0.5 / zoom;
+        center.setX( std::min( std::max( center.x(), halfSize ),
+                               1. - halfSize ) );
+        center.setY( std::min( std::max( center.y(), halfSize ),
+                               1. - halfSize ) );
+    }
+
+    QRectF visibleRect() const
+    {
+        const auto size = 1. / zoom;
+        return QRectF( center.x() - size/2, center.y() - size/2, size, size );
+    }
+
+    // Returns the coarsest level which provides at least one cell per
+    // pixel in each direction, unless the finest level is reached.
+    std::size_t levelFor( const QSize & widgetSize ) const
+    {
+        const auto & base = pyramid->level(0);
+        for ( auto i = pyramid->nLevels(); i-- > 0; )
+        {
+            const auto & level = pyramid->level(i);
+            const bool isFineEnoughX = level.width == base.width ||
+                    level.width / zoom >= widgetSize.width();
+            const bool isFineEnoughY = level.height == base.height ||
+                    level.height / zoom >= widgetSize.height();
+            if ( isFineEnoughX && isFineEnoughY )
+                return i;
+        }
+        return 0;
+    }
+
+    const QImage & image( std::size_t i )
+    {
+        if ( images[i].isNull() )
+        {
+            const auto & top = pyramid->level( pyramid->nLevels()-1 );
+            images[i] = createImage( pyramid->level(i),
+                                     top.mins.front(), top.maxs.front() );
+        }
+        return images[i];
+    }
+};
+
+
+HeatmapWidget::HeatmapWidget( QWidget * parent )
+    : QWidget( parent )
+{
+    m = std::make_unique<Impl>();
+}
+
+
+HeatmapWidget::~HeatmapWidget()
+{
+}
+
+
+void HeatmapWidget::setPyramid(
+        std::shared_ptr<const conv::MinMaxPyramid> pyramid )
+{
+    m->pyramid = std::move(pyramid);
+    m->images.clear();
+    if ( m->pyramid )
+        m->images.resize( m->pyramid->nLevels() );
+    update();
+}
+
+
+void HeatmapWidget::paintEvent( QPaintEvent * )
+{
+    QPainter painter( this );
+    painter.fillRect( rect(), palette().dark() );
+    if ( !m->pyramid || m->pyramid->level(0).mins.empty() )
+    {
+        painter.drawText( rect(), Qt::AlignCenter, "No data" );
+        return;
+    }
+    const auto & image = m->image( m->levelFor( size() ) );
+    const auto visible = m->visibleRect();
+    painter.drawImage( QRectF( rect() ), image,
+                       QRectF( visible.x() * image.width(),
+                               visible.y() * image.height(),
+                               visible.width() * image.width(),
+                               visible.height() * image.height() ) );
+}
+
+
+void HeatmapWidget::wheelEvent( QWheelEvent * event )
+{
+    if ( !m->pyramid )
+        return;
+#if QT_VERSION >= 0x050000
+    const auto nSteps = event->angleDelta().y() / 120.;
+#else
+    const auto nSteps = event->delta() / 120.;
+#endif
+    const auto & base = m->pyramid->level(0);
+    // Zooming stops when a single cell of the finest level fills the
+    // widget.
+    const auto maxZoom = double( std::max<std::size_t>(
+                std::max( base.width, base.height ), 1 ) );
+    const auto fraction = QPointF( double( event->pos().x() ) / width(),
+                                   double( event->pos().y() ) / height() );
+    // Keep the point under the mouse cursor in place.
+    const auto visible = m->visibleRect();
+    const auto anchor = QPointF(
+                visible.x() + fraction.x() * visible.width(),
+                visible.y() + fraction.y() * visible.height() );
+    m->zoom = std::min( std::max( m->zoom * std::pow( 1.25, nSteps ), 1. ),
+                        maxZoom );
+    const auto size = 1. / m->zoom;
+    m->center = QPointF( anchor.x() + ( 0.5 - fraction.x() ) * size,
+                         anchor.y() + ( 0.5 - fraction.y() ) * size );
+    m->clampCenter();
+    update();
+    event->accept();
+}
+
+
+void HeatmapWidget::mousePressEvent( QMouseEvent * event )
+{
+    m->lastMousePos = event->pos();
+}
+
+
+void HeatmapWidget::mouseMoveEvent( QMouseEvent * event )
+{
+    const auto delta = event->pos() - m->lastMousePos;
+    m->lastMousePos = event->pos();
+    m->center -= QPointF( double( delta.x() ) / width() / m->zoom,
+                          double( delta.y() ) / height() / m->zoom );
+    m->clampCenter();
+    update();
+}
+
+} // namespace gui
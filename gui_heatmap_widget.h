@@ -0,0 +1,48 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <QWidget>
+#include <memory>
+
+namespace conv
+{
+class MinMaxPyramid;
+}
+
+namespace gui
+{
+
+/// Shows a min/max pyramid of a matrix as a heatmap.
+///
+/// The color of each cell represents the maximum of the values in the
+/// corresponding block of the matrix, so that outliers stand out. The
+/// mouse wheel zooms and dragging pans the view. For each zoom factor the
+/// coarsest pyramid level is drawn which still provides at least one cell
+/// per pixel. The images of the levels are only created once.
+class HeatmapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HeatmapWidget( QWidget * parent = nullptr );
+    ~HeatmapWidget();
+
+    /// Shows the given pyramid. A null pointer clears the widget.
+    void setPyramid( std::shared_ptr<const conv::MinMaxPyramid> pyramid );
+
+protected:
+    void paintEvent( QPaintEvent * event ) override;
+    void wheelEvent( QWheelEvent * event ) override;
+    void mousePressEvent( QMouseEvent * event ) override;
+    void mouseMoveEvent( QMouseEvent * event ) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m;
+};
+
+} // namespace gui
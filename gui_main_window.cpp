@@ -1,23 +1,88 @@
 #include "gui_main_window.h"
 #include "ui_gui_main_window.h"
 
+#include "conv_conversion.h"
+#include "conv_mapped_file.h"
+#include "conv_min_max_pyramid.h"
+#include "gui_matrix_preview_model.h"
+
 #include "cpp_utils/exception.h"
-#include "cpp_utils/extract_by_line.h"
-#include "cpp_utils/more_algorithms.h"
 #include "cpp_utils/std_make_unique.h"
 #include "qt_utils/invoke_in_thread.h"
 #include "qt_utils/loop_thread.h"
 #include "qt_utils/serialize_props.h"
 
 #include <QFileDialog>
+#include <QMessageBox>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <fstream>
-#include <functional>
-#include <sstream>
 
 namespace gui
 {
 
+namespace
+{
+
+// Maximum width and height of the finest level of the heatmap.
+const std::size_t heatmapSize = 1024;
+
+
+// Returns a line for each stage with its hardware events per value and
+// per byte of the input file.
+QString describeStageCounts( const conv::ConversionReport & report )
+{
+    QString text;
+    const auto perValue = [&]( std::uint64_t count )
+    {
+        return double( count ) / std::max<std::size_t>( report.nValues, 1 );
+    };
+    for ( const auto & stage : report.stageCounts )
+    {
+        const auto & counts = stage.counts;
+        if ( counts.cycles == 0 )
+            return "Hardware event counters are not available.";
+        text += QString( "%1: %2 cycles/value, %3 cycles/byte, IPC %4, "
+                         "%5 cache misses/value, %6 branch misses/value, "
+                         "%7 dTLB misses/value\n" )
+                .arg( stage.stage.c_str() )
+                .arg( perValue( counts.cycles ), 0, 'f', 2 )
+                .arg( double( counts.cycles ) /
+                      std::max<std::size_t>( report.nInputBytes, 1 ),
+                      0, 'f', 2 )
+                .arg( counts.ipc(), 0, 'f', 2 )
+                .arg( perValue( counts.cacheMisses ), 0, 'f', 4 )
+                .arg( perValue( counts.branchMisses ), 0, 'f', 4 )
+                .arg( perValue( counts.dtlbMisses ), 0, 'f', 4 );
+    }
+    return text;
+}
+
+
+// Returns the shape of the matrix and a line for each of the first bad
+// lines.
+QString describeValidation( const conv::ValidationReport & report )
+{
+    auto text = QString( "%1 rows and %2 columns of %3, %4 empty lines, "
+                         "%5 bad lines.\n" )
+            .arg( report.nRows )
+            .arg( report.nCols )
+            .arg( conv::describe( report.numberType ) )
+            .arg( report.nEmptyLines )
+            .arg( report.nBadLines );
+    for ( const auto & error : report.firstErrors )
+        text += QString( "Line %1, field %2: %3\n" )
+                .arg( error.line )
+                .arg( error.column )
+                .arg( conv::describe( error, report.nCols ).c_str() );
+    return text;
+}
+
+} // unnamed namespace
+
+
 struct MainWindow::Impl
 {
     // Contains Qt user interface elements.
@@ -25,8 +90,27 @@ struct MainWindow::Impl
     // Objects which help to load the values in the gui input widgets
     // during construction and to store them during destruction.
     std::vector<std::unique_ptr<qu::PropertySerializer>> serializers;
+    // Provides the contents of the input file to the preview table.
+    MatrixPreviewModel previewModel;
 
+    // Runs the conversions and validations one after the other, so they
+    // never write the same files or change the settings of the thread
+    // pool and the tracing at the same time. They use the thread pool
+    // internally.
     qu::LoopThread conversionThread;
+
+    // Computes the heatmap of the input file in the background.
+    qu::LoopThread heatmapThread;
+    // Tells the running heatmap computation to stop.
+    std::shared_ptr<std::atomic<bool>> heatmapCancelled;
+    // Input file for which the heatmap has been computed.
+    std::string heatmapFileName;
+
+    void cancelHeatmap()
+    {
+        if ( heatmapCancelled )
+            *heatmapCancelled = true;
+    }
 };
 
 
@@ -35,6 +119,7 @@ MainWindow::MainWindow( QWidget * parent )
 {
     m = std::make_unique<Impl>();
     m->ui.setupUi(this);
+    m->ui.previewTableView->setModel( &m->previewModel );
 
     // set up serializers
     qu::createPropertySerializers( this->findChildren<QCheckBox*>(),
@@ -50,6 +135,8 @@ MainWindow::MainWindow( QWidget * parent )
 
 MainWindow::~MainWindow()
 {
+    m->cancelHeatmap();
+
     // store current values from gui input widget entries.
     std::ofstream file( "settings.txt" );
     writeProperties( file, m->serializers );
@@ -76,142 +163,249 @@ void MainWindow::selectOutputFiles()
 }
 
 
-void MainWindow::runConversion()
+void MainWindow::updatePreview()
 {
     const auto inputFileName =
             m->ui.inputFileLineEdit->text().toStdString();
-    const auto shallTranspose =
-            m->ui.transposeCheckBox->isChecked();
-    const auto shallCreateFileForEachRow =
-            m->ui.fileForEachRowCheckBox->isChecked();
-    const auto outputFileNames =
-            m->ui.outputFilesLineEdit->text().toStdString();
-    const auto replaceString =
-            m->ui.replaceCharsLineEdit->text().toStdString();
-
-    qu::invokeInThread( &m->conversionThread, [=]()
+    try
     {
-        std::ifstream inputFile{ inputFileName };
-
-        if ( !inputFile )
-            CU_THROW( "Could not open the file '" + inputFileName + "\'." );
+        m->previewModel.setFileName( inputFileName );
+    }
+    catch ( std::exception & e )
+    {
+        // The file might not exist anymore. This should not bother the
+        // user before the conversion is started.
+        m->ui.statusBar->showMessage(
+                    QString( "Preview not available: " ) + e.what(), 3000 );
+    }
+    updateHeatmap();
+}
 
-        const auto lines = cu::extractByLine( inputFile );
 
-        if ( inputFile.bad() )
-            CU_THROW( "The file '" + inputFileName +
-                      "' could not be read." );
-        if ( !inputFile.eof() )
-            CU_THROW( "The end of the file '\"'" + inputFileName +
-                      "' has not been reached." );
+void MainWindow::updateHeatmap()
+{
+    // The heatmap is only computed when it is shown, because this
+    // requires reading the whole input file.
+    const auto inputFileName =
+            m->ui.inputFileLineEdit->text().toStdString();
+    if ( m->ui.previewTabWidget->currentWidget() != m->ui.heatmapTab ||
+         inputFileName == m->heatmapFileName )
+        return;
+    m->heatmapFileName = inputFileName;
+    m->cancelHeatmap();
+    m->ui.heatmapWidget->setPyramid( nullptr );
+    if ( inputFileName.empty() )
+        return;
 
-        // extract the values from each line
-        std::vector<std::vector<double>> matrix;
-        size_t nLine = 0;
-        for ( const auto & line : lines )
+    const auto isCancelled = std::make_shared<std::atomic<bool>>( false );
+    m->heatmapCancelled = isCancelled;
+    qu::invokeInThread( &m->heatmapThread, [=]()
+    {
+        if ( *isCancelled )
+            return;
+        try
         {
-            ++nLine;
-            std::istringstream is(line);
-            matrix.push_back( {} );
-            std::copy( std::istream_iterator<double>(is),
-                       std::istream_iterator<double>(),
-                       std::back_inserter( matrix.back() ) );
-            if ( is.bad() || !is.eof() )
-                CU_THROW( "Line " + std::to_string(nLine) +
-                          " in file '" + inputFileName +
-                          "' could not be parsed to the end." );
+            const conv::MappedFile file( inputFileName );
+            // Show each intermediate result, so the heatmap is refined
+            // progressively while the file is read.
+            conv::computeMinMaxGrid( file, heatmapSize, heatmapSize,
+                [=]( const conv::MinMaxGrid & grid, double progress )
+            {
+                const std::shared_ptr<const conv::MinMaxPyramid> pyramid =
+                        std::make_shared<conv::MinMaxPyramid>( grid );
+                qu::invokeInGuiThread( [this, pyramid, progress, isCancelled]
+                {
+                    if ( *isCancelled )
+                        return;
+                    m->ui.heatmapWidget->setPyramid( pyramid );
+                    m->ui.statusBar->showMessage(
+                        progress < 1.
+                            ? QString( "Computing heatmap: %1%" )
+                                .arg( int( progress * 100 ) )
+                            : QString( "Heatmap complete." ), 3000 );
+                } );
+                return !*isCancelled;
+            } );
+        }
+        catch ( std::exception & e )
+        {
+            const auto message = std::string( e.what() );
+            qu::invokeInGuiThread( [this, message, isCancelled]
+            {
+                if ( !*isCancelled )
+                    m->ui.statusBar->showMessage( QString(
+                        "Heatmap not available: " ) + message.c_str(), 3000 );
+            } );
         }
+    } );
+}
 
-        // remove empty rows
-        matrix.erase( std::remove_if(
-                begin(matrix), end(matrix),
-                std::mem_fn(&std::vector<double>::empty) ),
-            end(matrix) );
 
-        if ( matrix.empty() )
-            CU_THROW( "The file '" + inputFileName +
-                      "' does not contain samples." );
+void MainWindow::runConversion()
+{
+    conv::ConversionOptions options;
+    options.inputFileName =
+            m->ui.inputFileLineEdit->text().toStdString();
+    options.shallTranspose =
+            m->ui.transposeCheckBox->isChecked();
+    options.shallCreateFileForEachRow =
+            m->ui.fileForEachRowCheckBox->isChecked();
+    options.outputFileNames =
+            m->ui.outputFilesLineEdit->text().toStdString();
+    options.replaceString =
+            m->ui.replaceCharsLineEdit->text().toStdString();
+    options.shallPinThreads =
+            m->ui.pinThreadsCheckBox->isChecked();
+    options.shallCountEvents =
+            m->ui.countEventsCheckBox->isChecked();
+    options.traceFileName =
+            m->ui.traceFileLineEdit->text().trimmed().toStdString();
+    // The items of the combo boxes are in the order of the enumerations.
+    options.hugePages = static_cast<conv::HugePages>(
+                m->ui.hugePagesComboBox->currentIndex() );
+    options.numberType = static_cast<conv::NumberType>(
+                m->ui.numberTypeComboBox->currentIndex() );
+    options.outputFormat = static_cast<conv::OutputFormat>(
+                m->ui.outputFormatComboBox->currentIndex() );
+    options.quantization.isPerColumn =
+            m->ui.quantizePerColumnCheckBox->isChecked();
+    options.isFixedWidth =
+            m->ui.fixedWidthCheckBox->isChecked();
 
-        // Check if all rows have the same length
-        nLine = 0;
-        for ( const auto & row : matrix )
+    if ( options.isFixedWidth )
+    {
+        for ( const auto & width : m->ui.fieldWidthsLineEdit->text().split(
+                  ' ', QString::SkipEmptyParts ) )
         {
-            ++nLine;
-            if ( row.size() != matrix.front().size() )
-                CU_THROW( "Row " + std::to_string( nLine ) +
-                          "of the matrix contains a different number of "
-                          "samples than the first row." );
+            bool isNumber = false;
+            options.fieldWidths.push_back( width.toULongLong( &isNumber ) );
+            if ( !isNumber || options.fieldWidths.back() == 0 )
+                CU_THROW( "The field widths must be positive numbers." );
         }
+    }
+
+    const auto skippedLines = m->ui.skippedLinesLineEdit->text().trimmed();
+    if ( !skippedLines.isEmpty() )
+    {
+        bool isNumber = false;
+        options.headerRules.nSkippedLines =
+                skippedLines.toULongLong( &isNumber );
+        if ( !isNumber )
+            CU_THROW( "The number of header lines to skip must be a "
+                      "number." );
+    }
+    options.headerRules.commentPrefix =
+            m->ui.commentPrefixLineEdit->text().trimmed().toStdString();
+    options.headerRules.hasColumnNames =
+            m->ui.columnNamesCheckBox->isChecked();
 
-        if ( shallTranspose )
+    options.missingValues.isEnabled =
+            m->ui.missingValuesCheckBox->isChecked();
+    options.missingValues.raggedRows = static_cast<conv::RaggedRows>(
+                m->ui.raggedRowsComboBox->currentIndex() );
+    const auto fillValue = m->ui.fillValueLineEdit->text().trimmed();
+    if ( !fillValue.isEmpty() )
+    {
+        bool isNumber = false;
+        options.missingValues.fillValue = fillValue.toDouble( &isNumber );
+        if ( !isNumber )
+            CU_THROW( "The fill value must be a number." );
+    }
+    options.missingValueBitmapFileName =
+            m->ui.missingValueBitmapLineEdit->text().toStdString();
+    options.badLines = static_cast<conv::BadLines>(
+                m->ui.badLinesComboBox->currentIndex() );
+    options.errorReportFileName =
+            m->ui.errorReportLineEdit->text().toStdString();
+
+    const auto range = m->ui.quantizationRangeLineEdit->text().split(
+                ' ', QString::SkipEmptyParts );
+    if ( !range.isEmpty() )
+    {
+        bool isMinNumber = false;
+        bool isMaxNumber = false;
+        if ( range.size() == 2 )
         {
-            std::vector<std::vector<double>> transposed( matrix.front().size() );
-
-            for ( const auto & row : matrix )
-                cu::for_each( begin(row), end(row),
-                              begin(transposed), end(transposed),
-                              []( double x, std::vector<double> & t )
-                              { t.push_back(x); } );
-            matrix.swap( transposed );
+            options.quantization.min = range[0].toDouble( &isMinNumber );
+            options.quantization.max = range[1].toDouble( &isMaxNumber );
         }
+        if ( !isMinNumber || !isMaxNumber )
+            CU_THROW( "The quantization range must consist of two numbers." );
+        options.quantization.isRangeFixed = true;
+    }
+
+    const auto memoryBudget = m->ui.memoryBudgetLineEdit->text().trimmed();
+    if ( !memoryBudget.isEmpty() )
+    {
+        bool isNumber = false;
+        const auto megabytes = memoryBudget.toULongLong( &isNumber );
+        if ( !isNumber || megabytes == 0 )
+            CU_THROW( "The memory budget must be a positive number of "
+                      "megabytes." );
+        options.memoryBudget = megabytes << 20;
+    }
 
-        if ( shallCreateFileForEachRow )
+    // A dry run only reads the input file.
+    if ( m->ui.validateOnlyCheckBox->isChecked() )
+    {
+        qu::invokeInThread( &m->conversionThread, [=]()
         {
-            if ( replaceString.empty() )
-                CU_THROW( "No characters to be replaced in the output file "
-                          "pattern have been specified." );
-            const auto it = cu::findBoyerMoore(
-                        begin(replaceString),
-                        end(replaceString),
-                        begin(outputFileNames),
-                        end(outputFileNames) );
-            if ( it == end(outputFileNames) )
-                CU_THROW( "Replacement characters could not be found "
-                          "in the output file pattern." );
-            const auto outputFileNamesFirstPart = std::string(
-                        begin(outputFileNames), it );
-            const auto outputFileNamesLastPart = std::string(
-                        it+replaceString.size(), end(outputFileNames) );
-            nLine = 0;
-            for ( const auto & row : matrix )
+            conv::ValidationReport report;
+            try
             {
-                ++nLine;
-                const auto outputFileName =
-                        outputFileNamesFirstPart +
-                        std::to_string(nLine) +
-                        outputFileNamesLastPart;
-                std::ofstream outputFile( outputFileName );
-                std::copy( begin(row), end(row),
-                           std::ostream_iterator<double>(outputFile, " ") );
-                outputFile << std::endl;
-                if ( !outputFile.good() )
-                    CU_THROW( "Failed to write row " +
-                              std::to_string(nLine) +
-                              " to the file '" +
-                              outputFileName + "'." );
+                report = conv::validate( options );
             }
-        }
-        else // (!shallCreateFileForEachRow)
-        {
-            nLine = 0;
-            std::ofstream outputFile( outputFileNames );
-            for ( const auto & row : matrix )
+            catch (...)
             {
-                ++nLine;
-                std::copy( begin(row), end(row),
-                           std::ostream_iterator<double>(outputFile, " ") );
-                outputFile << std::endl;
-                if ( !outputFile.good() )
-                    CU_THROW( "Failed to write row " +
-                              std::to_string(nLine) +
-                              " to the file '" +
-                              outputFileNames + "'." );
+                const auto e = std::current_exception();
+                qu::invokeInGuiThread(
+                            [e] { std::rethrow_exception( e ); } );
+                return;
             }
+            qu::invokeInGuiThread( [this, report]
+            {
+                QMessageBox::information( this, "Validation",
+                                          describeValidation( report ) );
+            } );
+        } );
+        return;
+    }
+
+    qu::invokeInThread( &m->conversionThread, [=]()
+    {
+        conv::ConversionReport report;
+        try
+        {
+            report = conv::convert( options );
+        }
+        catch (...)
+        {
+            // Let the application report the error in the gui thread.
+            const auto e = std::current_exception();
+            qu::invokeInGuiThread( [e] { std::rethrow_exception( e ); } );
+            return;
         }
-        qu::invokeInGuiThread( [this]
+        qu::invokeInGuiThread( [this, report]
         {
-            m->ui.statusBar->showMessage(
-                   "Files written successfully.", 3000 );
+            auto message = QString( "Files written successfully "
+                                    "(%1, %2, about %3 MB)." )
+                    .arg( conv::describe( report.numberType ) )
+                    .arg( conv::describe( report.strategy ) )
+                    .arg( ( report.estimatedBytes >> 20 ) + 1 );
+            if ( report.nBadLines > 0 )
+                message += QString( " %1 bad lines were skipped or filled." )
+                        .arg( report.nBadLines );
+            if ( report.nMissingValues > 0 )
+                message += QString( " %1 missing values were filled in." )
+                        .arg( report.nMissingValues );
+            if ( report.transposeSeconds > 0 )
+                message += QString( " Transposition took %1 s using %2." )
+                        .arg( report.transposeSeconds )
+                        .arg( conv::describe( report.hugePages ) );
+            m->ui.statusBar->showMessage( message, 3000 );
+            if ( !report.stageCounts.empty() )
+                QMessageBox::information( this, "Hardware Events",
+                                          describeStageCounts( report ) );
         } );
     } );
 }
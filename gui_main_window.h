@@ -23,6 +23,8 @@ private slots:
     void selectInputFile();
     void selectOutputFiles();
     void runConversion();
+    void updatePreview();
+    void updateHeatmap();
     
 private:
     struct Impl;
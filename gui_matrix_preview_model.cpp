@@ -0,0 +1,240 @@
+#include "gui_matrix_preview_model.h"
+
+#include "conv_line_index.h"
+#include "conv_mapped_file.h"
+#include "conv_parsing.h"
+#include "cpp_utils/std_make_unique.h"
+
+#include <QBrush>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace gui
+{
+
+namespace
+{
+
+// Number of bytes which are indexed when a file is opened and each
+// time the view asks for more rows.
+const std::size_t scanChunkSize = 4 << 20;
+// Number of lines which are parsed in order to determine the number
+// of columns to be shown initially.
+const std::size_t nLinesForColumnCount = 100;
+// Number of parsed rows which are kept in the cache.
+const std::size_t cacheSize = 256;
+
+struct Cell
+{
+    const char * first;
+    const char * last;
+    double value;
+    bool isNumber;
+};
+
+struct CachedRow
+{
+    std::size_t row = std::numeric_limits<std::size_t>::max();
+    std::vector<Cell> cells;
+};
+
+void parseRow( std::pair<const char *, const char *> line,
+               std::vector<Cell> & cells )
+{
+    cells.clear();
+    conv::forEachToken( line.first, line.second,
+        [&]( const char * first, const char * last )
+    {
+        Cell cell{ first, last, 0., false };
+        cell.isNumber = conv::parseDouble( first, last, cell.value );
+        cells.push_back( cell );
+    } );
+}
+
+} // unnamed namespace
+
+
+struct MatrixPreviewModel::Impl
+{
+    std::unique_ptr<conv::MappedFile> file;
+    std::unique_ptr<conv::LineIndex> index;
+    // Number of rows and columns which have been announced to the views.
+    int nRows = 0;
+    int nColumns = 0;
+    // Number of values of the widest row which has been parsed.
+    mutable std::size_t nSeenColumns = 0;
+    // Whether showSeenColumns() has been queued.
+    bool isColumnUpdatePending = false;
+    // Direct mapped cache of parsed rows. Row i is stored in the slot
+    // i % cacheSize.
+    mutable std::vector<CachedRow> cache;
+
+    int nIndexedRows() const
+    {
+        return static_cast<int>( std::min<std::size_t>(
+                    index->nLines(), std::numeric_limits<int>::max() ) );
+    }
+
+    int nShownColumns() const
+    {
+        return static_cast<int>( std::min<std::size_t>(
+                    nSeenColumns, std::numeric_limits<int>::max() ) );
+    }
+
+    const CachedRow & row( std::size_t i ) const
+    {
+        auto & cachedRow = cache[i % cacheSize];
+        if ( cachedRow.row != i )
+        {
+            parseRow( index->line(i), cachedRow.cells );
+            cachedRow.row = i;
+            nSeenColumns = std::max( nSeenColumns, cachedRow.cells.size() );
+        }
+        return cachedRow;
+    }
+};
+
+
+MatrixPreviewModel::MatrixPreviewModel( QObject * parent )
+    : QAbstractTableModel( parent )
+{
+    m = std::make_unique<Impl>();
+}
+
+
+MatrixPreviewModel::~MatrixPreviewModel()
+{
+}
+
+
+void MatrixPreviewModel::setFileName( const std::string & fileName )
+{
+    beginResetModel();
+    m->cache.clear();
+    m->index.reset();
+    m->file.reset();
+    m->nRows = 0;
+    m->nColumns = 0;
+    m->nSeenColumns = 0;
+    try
+    {
+        if ( !fileName.empty() )
+        {
+            m->file = std::make_unique<conv::MappedFile>( fileName );
+            m->index = std::make_unique<conv::LineIndex>(
+                        m->file->begin(), m->file->end() );
+            m->index->scanMore( scanChunkSize );
+            m->cache.resize( cacheSize );
+            m->nRows = m->nIndexedRows();
+            const auto nLines = std::min<std::size_t>(
+                        m->nRows, nLinesForColumnCount );
+            for ( std::size_t i = 0; i < nLines; ++i )
+                m->row(i);
+            m->nColumns = m->nShownColumns();
+        }
+    }
+    catch (...)
+    {
+        m->index.reset();
+        m->file.reset();
+        m->nRows = 0;
+        m->nColumns = 0;
+        m->nSeenColumns = 0;
+        endResetModel();
+        throw;
+    }
+    endResetModel();
+}
+
+
+int MatrixPreviewModel::rowCount( const QModelIndex & parent ) const
+{
+    return parent.isValid() ? 0 : m->nRows;
+}
+
+
+int MatrixPreviewModel::columnCount( const QModelIndex & parent ) const
+{
+    return parent.isValid() ? 0 : m->nColumns;
+}
+
+
+QVariant MatrixPreviewModel::data( const QModelIndex & index, int role ) const
+{
+    if ( !index.isValid() )
+        return QVariant();
+    const auto & cells = m->row( index.row() ).cells;
+    // The model must not change while the view asks for data.
+    if ( m->nShownColumns() > m->nColumns && !m->isColumnUpdatePending )
+    {
+        m->isColumnUpdatePending = true;
+        QMetaObject::invokeMethod( const_cast<MatrixPreviewModel *>( this ),
+                                   "showSeenColumns", Qt::QueuedConnection );
+    }
+    if ( static_cast<std::size_t>( index.column() ) >= cells.size() )
+        return QVariant();
+    const auto & cell = cells[index.column()];
+    switch ( role )
+    {
+    case Qt::DisplayRole:
+        // Numbers are shown the way they will be written to the output.
+        return cell.isNumber
+                ? QString::number( cell.value, 'g', 6 )
+                : QString::fromLatin1( cell.first, cell.last - cell.first );
+    case Qt::ToolTipRole:
+        return cell.isNumber
+                ? QString::fromLatin1( cell.first, cell.last - cell.first )
+                : QString( "Not a number" );
+    case Qt::ForegroundRole:
+        return cell.isNumber ? QVariant() : QVariant( QBrush( Qt::red ) );
+    case Qt::TextAlignmentRole:
+        return int( Qt::AlignRight | Qt::AlignVCenter );
+    default:
+        return QVariant();
+    }
+}
+
+
+QVariant MatrixPreviewModel::headerData(
+        int section, Qt::Orientation orientation, int role ) const
+{
+    if ( role != Qt::DisplayRole )
+        return QAbstractTableModel::headerData( section, orientation, role );
+    // Lines and columns are counted from one, as in error messages.
+    return section + 1;
+}
+
+
+bool MatrixPreviewModel::canFetchMore( const QModelIndex & parent ) const
+{
+    return !parent.isValid() && m->index && !m->index->isComplete();
+}
+
+
+void MatrixPreviewModel::fetchMore( const QModelIndex & parent )
+{
+    if ( !canFetchMore( parent ) )
+        return;
+    m->index->scanMore( scanChunkSize );
+    const auto nRows = m->nIndexedRows();
+    if ( nRows == m->nRows )
+        return;
+    beginInsertRows( QModelIndex(), m->nRows, nRows-1 );
+    m->nRows = nRows;
+    endInsertRows();
+}
+
+
+void MatrixPreviewModel::showSeenColumns()
+{
+    m->isColumnUpdatePending = false;
+    const auto nColumns = m->nShownColumns();
+    if ( nColumns <= m->nColumns )
+        return;
+    beginInsertColumns( QModelIndex(), m->nColumns, nColumns-1 );
+    m->nColumns = nColumns;
+    endInsertColumns();
+}
+
+} // namespace gui
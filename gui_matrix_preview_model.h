@@ -0,0 +1,56 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <memory>
+#include <string>
+
+namespace gui
+{
+
+/// Table model which shows the values contained in a matrix file.
+///
+/// The file is mapped into memory and only indexed and parsed as far as
+/// the user scrolls through it. Hence even files of several gigabytes
+/// open instantly and the memory consumption does not depend on the
+/// size of the file.
+///
+/// The number of columns is taken from the first lines. If a row with
+/// more values is shown later on, then columns are added for them.
+class MatrixPreviewModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit MatrixPreviewModel( QObject * parent = nullptr );
+    ~MatrixPreviewModel();
+
+    /// Shows the contents of the given file.
+    ///
+    /// An empty file name clears the model. Throws, if the file cannot be
+    /// opened. In this case the model is cleared as well.
+    void setFileName( const std::string & fileName );
+
+    int rowCount( const QModelIndex & parent = QModelIndex() ) const override;
+    int columnCount( const QModelIndex & parent = QModelIndex() ) const override;
+    QVariant data( const QModelIndex & index,
+                   int role = Qt::DisplayRole ) const override;
+    QVariant headerData( int section, Qt::Orientation orientation,
+                         int role = Qt::DisplayRole ) const override;
+    bool canFetchMore( const QModelIndex & parent ) const override;
+    void fetchMore( const QModelIndex & parent ) override;
+
+private slots:
+    // Adds columns for the values of the widest row which has been shown.
+    void showSeenColumns();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m;
+};
+
+} // namespace gui
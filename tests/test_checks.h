@@ -0,0 +1,22 @@
+/// @file
+///
+/// @author Ralph Tandetzky
+/// @date 17 Oct 2026
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+/// Ends the test program with exit code 1 and prints the place of the
+/// check, if the condition is false.
+#define CHECK( condition ) \
+    do \
+    { \
+        if ( !( condition ) ) \
+        { \
+            std::fprintf( stderr, "%s:%d: check failed: %s\n", \
+                          __FILE__, __LINE__, #condition ); \
+            std::exit( 1 ); \
+        } \
+    } while ( false )
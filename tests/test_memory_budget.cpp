@@ -0,0 +1,145 @@
+#include "conv_conversion.h"
+#include "test_checks.h"
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace
+{
+
+// The matrix takes 48 MB as doubles, six times the budget.
+const std::size_t nRows = 6000;
+const std::size_t nCols = 1000;
+const std::size_t memoryBudget = 8 << 20;
+
+// Memory the conversion may use beyond the budget for the values, e.g.
+// for the text of the block which is being parsed, the formatted output
+// and the stacks of the worker threads. The in-memory conversion needs
+// more than the budget plus this margin.
+const std::size_t margin = 32 << 20;
+
+// The in-memory conversion may use twice the memory of the values, e.g.
+// for the values and the text of the input, which is released while it
+// is parsed.
+const std::size_t inMemoryLimit = 2 * nRows * nCols * sizeof(double);
+
+const char * const inputFileName = "test_memory_budget_input.txt";
+
+
+// Writes the matrix line by line, so the test itself needs little memory.
+void writeInput()
+{
+    std::ofstream file( inputFileName );
+    std::mt19937 random( 42 );
+    std::uniform_int_distribution<int> value( -99999, 99999 );
+    for ( std::size_t i = 0; i < nRows; ++i )
+    {
+        std::string line;
+        for ( std::size_t j = 0; j < nCols; ++j )
+        {
+            char field[16];
+            const auto v = value( random );
+            std::snprintf( field, sizeof(field), "%s%d.%02d ",
+                           v < 0 ? "-" : "", std::abs( v / 100 ),
+                           std::abs( v % 100 ) );
+            line += field;
+        }
+        line.back() = '\n';
+        file << line;
+    }
+    CHECK( file.good() );
+}
+
+
+// Returns the peak resident memory of the process so far in bytes.
+std::size_t peakResidentBytes()
+{
+    rusage usage;
+    CHECK( getrusage( RUSAGE_SELF, &usage ) == 0 );
+    // Linux reports kilobytes.
+    return std::size_t( usage.ru_maxrss ) * 1024;
+}
+
+
+std::string readFile( const std::string & fileName )
+{
+    std::ifstream file( fileName, std::ios::binary );
+    return std::string( std::istreambuf_iterator<char>( file ),
+                        std::istreambuf_iterator<char>() );
+}
+
+
+// Runs the conversion in a child process, so that its peak resident
+// memory is measured from the memory of this process and not from the
+// peak of earlier conversions. Checks whether the matrix is held in
+// memory and that the peak grows by at most @c maxGrowth bytes.
+void checkConversion( const conv::ConversionOptions & options,
+                      bool isInMemory, std::size_t maxGrowth )
+{
+    const auto pid = fork();
+    CHECK( pid >= 0 );
+    if ( pid == 0 )
+    {
+        const auto peakBefore = peakResidentBytes();
+        const auto report = conv::convert( options );
+        CHECK( ( report.strategy == conv::MemoryStrategy::InMemory ) ==
+               isInMemory );
+        CHECK( peakResidentBytes() <= peakBefore + maxGrowth );
+        std::exit( 0 );
+    }
+    int status = 0;
+    CHECK( waitpid( pid, &status, 0 ) == pid );
+    CHECK( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+}
+
+
+conv::ConversionOptions conversionOptions( bool shallTranspose,
+                                           std::size_t memoryBudget )
+{
+    conv::ConversionOptions options;
+    options.inputFileName = inputFileName;
+    options.outputFileNames = std::string( "test_memory_budget_" ) +
+            ( shallTranspose ? "transposed" : "plain" ) +
+            ( memoryBudget != 0 ? "_budget.txt" : ".txt" );
+    options.shallTranspose = shallTranspose;
+    options.numberType = conv::NumberType::Double;
+    options.memoryBudget = memoryBudget;
+    return options;
+}
+
+} // unnamed namespace
+
+
+int main()
+{
+    writeInput();
+
+    // Each conversion runs in a process of its own, since the peak of a
+    // process only grows. No conversion runs in this process, so that
+    // the children do not inherit its threads or memory.
+    for ( const bool shallTranspose : { false, true } )
+    {
+        const auto budgetOptions =
+                conversionOptions( shallTranspose, memoryBudget );
+        const auto inMemoryOptions = conversionOptions( shallTranspose, 0 );
+        checkConversion( budgetOptions, false, memoryBudget + margin );
+        checkConversion( inMemoryOptions, true, inMemoryLimit );
+
+        // The output must not depend on the strategy.
+        CHECK( readFile( budgetOptions.outputFileNames ) ==
+               readFile( inMemoryOptions.outputFileNames ) );
+        std::remove( budgetOptions.outputFileNames.c_str() );
+        std::remove( inMemoryOptions.outputFileNames.c_str() );
+    }
+    std::remove( inputFileName );
+}
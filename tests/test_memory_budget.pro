@@ -0,0 +1,6 @@
+include( tests.pri )
+
+TARGET = test_memory_budget
+
+SOURCES += \
+	test_memory_budget.cpp \
@@ -0,0 +1,189 @@
+#include "conv_quantized_writer.h"
+#include "test_checks.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const char * const fileName = "test_quantized_writer.bin";
+
+
+// The contents of a quantized file.
+struct QuantizedFile
+{
+    std::uint32_t type = 0;
+    std::uint64_t nRows = 0;
+    std::uint64_t nCols = 0;
+    std::vector<double> scales;
+    std::vector<double> offsets;
+    std::vector<std::int16_t> values;
+};
+
+
+std::uint64_t readLittleEndian( const std::string & bytes, std::size_t & pos,
+                                std::size_t size )
+{
+    CHECK( pos + size <= bytes.size() );
+    std::uint64_t value = 0;
+    for ( std::size_t k = 0; k < size; ++k )
+        value |= std::uint64_t( std::uint8_t( bytes[pos+k] ) ) << ( 8*k );
+    pos += size;
+    return value;
+}
+
+
+double readDouble( const std::string & bytes, std::size_t & pos )
+{
+    const auto bits = readLittleEndian( bytes, pos, 8 );
+    double value;
+    std::memcpy( &value, &bits, sizeof(value) );
+    return value;
+}
+
+
+// Reads a file with 16 bit integers and checks its layout.
+QuantizedFile readFile()
+{
+    std::ifstream file( fileName, std::ios::binary );
+    const std::string bytes( ( std::istreambuf_iterator<char>( file ) ),
+                             std::istreambuf_iterator<char>() );
+    CHECK( bytes.compare( 0, 8, "CMQUANT1" ) == 0 );
+    std::size_t pos = 8;
+    QuantizedFile result;
+    result.type = std::uint32_t( readLittleEndian( bytes, pos, 4 ) );
+    const auto nPairs = readLittleEndian( bytes, pos, 4 );
+    result.nRows = readLittleEndian( bytes, pos, 8 );
+    result.nCols = readLittleEndian( bytes, pos, 8 );
+    for ( std::uint64_t k = 0; k < nPairs; ++k )
+    {
+        result.scales.push_back( readDouble( bytes, pos ) );
+        result.offsets.push_back( readDouble( bytes, pos ) );
+    }
+    while ( pos < bytes.size() )
+        result.values.push_back(
+                    std::int16_t( readLittleEndian( bytes, pos, 2 ) ) );
+    CHECK( result.values.size() == result.nRows * result.nCols );
+    std::remove( fileName );
+    return result;
+}
+
+
+// Writes the rows with a fixed range or, if none is given, with the
+// ranges of the columns.
+QuantizedFile writeFile( std::vector<double> values,
+                         std::size_t nRows, std::size_t nCols,
+                         bool isPerColumn,
+                         const conv::ValueRange * fixedRange )
+{
+    const conv::StridedView<double> rows(
+                values.data(), nRows, nCols, nCols );
+    auto ranges = fixedRange ? std::vector<conv::ValueRange>{ *fixedRange }
+                             : conv::columnRanges( rows );
+    if ( !fixedRange && !isPerColumn )
+        ranges = { conv::unite( ranges ) };
+    conv::QuantizedMatrixWriter<double> writer(
+                fileName, conv::QuantizedType::Int16, ranges, isPerColumn );
+    writer.append( rows );
+    writer.finish();
+    return readFile();
+}
+
+
+// Checks that the values are restored within half a step.
+void checkValues( const QuantizedFile & file,
+                  const std::vector<double> & values )
+{
+    const auto nPairs = file.scales.size();
+    for ( std::size_t i = 0; i < file.nRows; ++i )
+        for ( std::size_t j = 0; j < file.nCols; ++j )
+        {
+            const auto k = nPairs == 1 ? 0 : j;
+            const auto p = i*file.nCols + j;
+            const auto restored =
+                    file.offsets[k] + file.scales[k] * file.values[p];
+            CHECK( std::fabs( restored - values[p] ) <=
+                   0.5 * file.scales[k] * ( 1 + 1e-9 ) );
+        }
+}
+
+} // unnamed namespace
+
+
+int main()
+{
+    const std::size_t nRows = 5;
+    const std::size_t nCols = 3;
+    std::vector<double> values;
+    for ( std::size_t i = 0; i < nRows; ++i )
+        for ( std::size_t j = 0; j < nCols; ++j )
+            values.push_back( double( i ) * ( j + 1 ) - 2.5 );
+    conv::ValueRange fixedRange;
+    fixedRange.min = -10;
+    fixedRange.max = 10;
+
+    // A fixed range is written as the pair of each column, if the
+    // quantization is per column.
+    auto file = writeFile( values, nRows, nCols, true, &fixedRange );
+    CHECK( file.type == 1 );
+    CHECK( file.nRows == nRows && file.nCols == nCols );
+    CHECK( file.scales.size() == nCols );
+    for ( std::size_t j = 1; j < nCols; ++j )
+        CHECK( file.scales[j] == file.scales[0] &&
+               file.offsets[j] == file.offsets[0] );
+    CHECK( std::fabs( file.offsets[0] + file.scales[0] * -32768 + 10 ) <
+           1e-9 );
+    checkValues( file, values );
+
+    // Otherwise there is a single pair.
+    file = writeFile( values, nRows, nCols, false, &fixedRange );
+    CHECK( file.scales.size() == 1 );
+    checkValues( file, values );
+
+    // The ranges of the columns give a pair for each column.
+    file = writeFile( values, nRows, nCols, true, nullptr );
+    CHECK( file.scales.size() == nCols );
+    CHECK( file.scales[0] != file.scales[2] );
+    checkValues( file, values );
+    file = writeFile( values, nRows, nCols, false, nullptr );
+    CHECK( file.scales.size() == 1 );
+    checkValues( file, values );
+
+    // Without rows the columns still get their pairs.
+    file = writeFile( {}, 0, nCols, true, &fixedRange );
+    CHECK( file.nRows == 0 && file.nCols == nCols );
+    CHECK( file.scales.size() == nCols );
+    file = writeFile( {}, 0, nCols, true, nullptr );
+    CHECK( file.nRows == 0 && file.nCols == nCols );
+    CHECK( file.scales.size() == nCols );
+
+    // Without any columns there is a single pair, e.g. the fixed one,
+    // even if nothing has been appended.
+    {
+        conv::QuantizedMatrixWriter<double> writer(
+                    fileName, conv::QuantizedType::Int16, { fixedRange },
+                    true );
+        writer.finish();
+    }
+    file = readFile();
+    CHECK( file.nRows == 0 && file.nCols == 0 );
+    CHECK( file.scales.size() == 1 );
+    CHECK( std::fabs( file.offsets[0] + file.scales[0] * -32768 + 10 ) <
+           1e-9 );
+    {
+        conv::QuantizedMatrixWriter<double> writer(
+                    fileName, conv::QuantizedType::Int16, {}, true );
+        writer.finish();
+    }
+    file = readFile();
+    CHECK( file.nRows == 0 && file.nCols == 0 );
+    CHECK( file.scales.size() == 1 );
+}
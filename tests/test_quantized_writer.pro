@@ -0,0 +1,6 @@
+include( tests.pri )
+
+TARGET = test_quantized_writer
+
+SOURCES += \
+	test_quantized_writer.cpp \
@@ -0,0 +1,49 @@
+#include "conv_transpose.h"
+#include "test_checks.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+// Transposes a matrix whose values are their positions and checks that
+// each value arrives at its transposed position.
+template <typename T>
+bool isTransposedCorrectly( std::size_t nRows, std::size_t nCols )
+{
+    std::vector<T> values( nRows * nCols );
+    for ( std::size_t p = 0; p < values.size(); ++p )
+        values[p] = T( p );
+    conv::transposeInPlace( values.data(), nRows, nCols );
+    for ( std::size_t i = 0; i < nRows; ++i )
+        for ( std::size_t j = 0; j < nCols; ++j )
+            if ( values[j*nRows+i] != T( i*nCols+j ) )
+                return false;
+    return true;
+}
+
+} // unnamed namespace
+
+
+int main()
+{
+    // All small shapes, including those whose dimensions divide each
+    // other and those which have common divisors.
+    for ( std::size_t nRows = 1; nRows <= 40; ++nRows )
+        for ( std::size_t nCols = 1; nCols <= 40; ++nCols )
+            CHECK( isTransposedCorrectly<std::int32_t>( nRows, nCols ) );
+
+    // Large shapes with coprime dimensions, long cycles and several
+    // panels and tasks in each step.
+    CHECK( isTransposedCorrectly<double>( 2003, 3001 ) );
+    CHECK( isTransposedCorrectly<double>( 3001, 2003 ) );
+    CHECK( isTransposedCorrectly<std::int64_t>( 7, 1000003 ) );
+    CHECK( isTransposedCorrectly<std::int64_t>( 1000003, 7 ) );
+
+    // Large shapes with a common divisor and with multiples.
+    CHECK( isTransposedCorrectly<double>( 1536, 2560 ) );
+    CHECK( isTransposedCorrectly<double>( 4096, 512 ) );
+    CHECK( isTransposedCorrectly<double>( 512, 4096 ) );
+}
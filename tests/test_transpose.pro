@@ -0,0 +1,6 @@
+include( tests.pri )
+
+TARGET = test_transpose
+
+SOURCES += \
+	test_transpose.cpp \
@@ -0,0 +1,49 @@
+# Settings shared by the test programs. They are linked with the
+# conversion engine, but not with the gui.
+
+QT       -= core gui
+QMAKE_CXXFLAGS += -std=c++11 -pedantic
+
+TEMPLATE = app
+CONFIG += console c++11 link_prl
+CONFIG -= app_bundle qt
+
+DEPENDPATH += .. ../../cpp_utils/
+INCLUDEPATH += .. ../..
+
+HEADERS  += \
+	test_checks.h \
+
+SOURCES += \
+	../conv_arrow_writer.cpp \
+	../conv_buffer.cpp \
+	../conv_chunk_file_writer.cpp \
+	../conv_column_major_writer.cpp \
+	../conv_conversion.cpp \
+	../conv_encoding.cpp \
+	../conv_fixed_width.cpp \
+	../conv_flat_buffer.cpp \
+	../conv_formatting.cpp \
+	../conv_header.cpp \
+	../conv_line_index.cpp \
+	../conv_mapped_file.cpp \
+	../conv_memory_plan.cpp \
+	../conv_min_max_pyramid.cpp \
+	../conv_missing_values.cpp \
+	../conv_numa.cpp \
+	../conv_parse_errors.cpp \
+	../conv_parsing.cpp \
+	../conv_perf_counters.cpp \
+	../conv_quantized_writer.cpp \
+	../conv_row_reader.cpp \
+	../conv_thread_pool.cpp \
+	../conv_trace.cpp \
+
+LIBS += \
+	-L../../cpp_utils -lcpp_utils \
+	-lpthread \
+
+numa {
+	DEFINES += CONVERT_MATRIX_USE_LIBNUMA
+	LIBS += -lnuma
+}
@@ -0,0 +1,9 @@
+# Builds a console program for each test. Run them from the build
+# directory. Each returns a non-zero exit code, if a check fails.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+	test_memory_budget.pro \
+	test_quantized_writer.pro \
+	test_transpose.pro \